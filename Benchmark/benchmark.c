@@ -0,0 +1,247 @@
+/**
+ * @file benchmark.c
+ * @brief Programa de benchmark das operacoes sobre antenas e grafos.
+ *
+ * Gera mapas sinteticos (MapGenerator) em varias escalas e mede o tempo de
+ * leitura, detect_nefasto, construcao do grafo, DFS/BFS, caminhos e intersecoes.
+ * O resultado e escrito em CSV no stdout:
+ *   seed,rows,cols,density,types,clustering,antennas,phase,rep,seconds
+ *
+ * Uso: Benchmark [--size RxC]... [--density D] [--types N] [--clustering C]
+ *                [--seed S] [--reps N] [--paths-max-component N]
+ *                [--nefasto-max-antennas N] [--map ficheiro] [--report 1]
+ *
+ * Com --report 1 o relatorio de Instrumentation (contadores e tempos por fase) e
+ * escrito em JSON no stderr; so tem contadores se compilado com EDA_INSTRUMENTATION.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ListHandler.h"
+#include "GraphHandler.h"
+#include "MapGenerator.h"
+#include "Instrumentation.h"
+
+#define MAX_SIZES 32
+
+#pragma region Structs
+
+/**
+ * @struct BenchConfig
+ * @brief Configuracao de uma execucao do benchmark.
+ */
+typedef struct BenchConfig {
+    MapGenOptions gen;          /**< Parametros do gerador (rows/cols por escala) */
+    int sizes[MAX_SIZES][2];    /**< Escalas a medir (linhas, colunas) */
+    int numSizes;               /**< Numero de escalas */
+    int reps;                   /**< Repeticoes por escala */
+    int pathsMaxComponent;      /**< Tamanho maximo da componente usada em all_paths */
+    int nefastoMaxAntennas;     /**< Acima deste numero de antenas detect_nefasto nao e medido */
+    const char* mapFile;        /**< Ficheiro temporario onde o mapa e escrito */
+    bool report;                /**< Escrever o relatorio de instrumentacao no stderr */
+} BenchConfig;
+
+#pragma endregion
+
+#pragma region Medicao
+
+/**
+ * Funcao para escrever uma linha de resultado em CSV.
+ *
+ * \param gen - parametros do mapa medido
+ * \param antennas - numero de antenas no mapa
+ * \param phase - nome da fase medida
+ * \param rep - numero da repeticao
+ * \param seconds - duracao da fase
+ */
+static void report(const MapGenOptions* gen, int antennas, const char* phase, int rep, double seconds) {
+    printf("%u,%d,%d,%.4f,%d,%.2f,%d,%s,%d,%.9f\n", gen->seed, gen->rows, gen->cols, gen->density,
+        gen->numTypes, gen->clustering, antennas, phase, rep, seconds);
+}
+
+#pragma endregion
+
+#pragma region Fases
+
+/**
+ * Funcao para escolher os extremos de all_paths: a primeira componente com
+ * entre 2 e maxComponent antenas (a enumeracao e exponencial no tamanho da componente).
+ *
+ * \param graph - ponteiro para o grafo
+ * \param maxComponent - tamanho maximo da componente
+ * \param start - vertice de partida escolhido
+ * \param end - vertice de destino escolhido
+ * \return true se foi encontrada uma componente adequada
+ */
+static bool pick_path_endpoints(Graph* graph, int maxComponent, Vertex** start, Vertex** end) {
+    int* ids = (int*)malloc(sizeof(int) * (graph->numVertices > 0 ? graph->numVertices : 1));
+    bool* seen = (bool*)calloc(graph->numVertices > 0 ? graph->numVertices : 1, sizeof(bool));
+    bool found = false;
+
+    for (int id = 0; id < graph->numVertices && !found; id++) {
+        if (seen[id]) continue;
+        Vertex* v = get_vertex(graph, id);
+        int n = dfs_collect(graph, v->row + 1, v->col + 1, ids, graph->numVertices);
+        for (int i = 0; i < n; i++) seen[ids[i]] = true;
+        if (n >= 2 && n <= maxComponent) {
+            *start = get_vertex(graph, ids[0]);
+            *end = get_vertex(graph, ids[n - 1]);
+            found = true;
+        }
+    }
+
+    free(ids);
+    free(seen);
+    return found;
+}
+
+/**
+ * Funcao para medir todas as fases numa escala.
+ *
+ * \param config - configuracao do benchmark
+ * \param rows - linhas do mapa
+ * \param cols - colunas do mapa
+ * \return 0 em caso de sucesso
+ */
+static int run_scale(const BenchConfig* config, int rows, int cols) {
+    MapGenOptions gen = config->gen;
+    gen.rows = rows;
+    gen.cols = cols;
+    if (!write_generated_map(config->mapFile, &gen)) return 1;
+
+    for (int rep = 0; rep < config->reps; rep++) {
+        Node* root = NULL;
+        int r, c;
+        double t0 = instr_now();
+        read_matrix_from_file(config->mapFile, &root, &r, &c);
+        double t1 = instr_now();
+        int antennas = visit_antennas(root, NULL, NULL);
+        report(&gen, antennas, "load", rep, t1 - t0);
+
+        if (antennas <= config->nefastoMaxAntennas) {
+            t0 = instr_now();
+            detect_nefasto(&root);
+            report(&gen, antennas, "detect_nefasto", rep, instr_now() - t0);
+        }
+        deallocate(&root);
+
+        t0 = instr_now();
+        Graph* graph = read_graph_from_file(config->mapFile, &r, &c);
+        report(&gen, antennas, "graph_build", rep, instr_now() - t0);
+        if (!graph) return 1;
+
+        if (graph->numVertices > 0) {
+            Vertex* first = get_vertex(graph, 0);
+            t0 = instr_now();
+            dfs_visit(graph, first->row + 1, first->col + 1, NULL, NULL);
+            report(&gen, antennas, "dfs", rep, instr_now() - t0);
+
+            t0 = instr_now();
+            bfs_visit(graph, first->row + 1, first->col + 1, NULL, NULL);
+            report(&gen, antennas, "bfs", rep, instr_now() - t0);
+        }
+
+        Vertex* start;
+        Vertex* end;
+        if (pick_path_endpoints(graph, config->pathsMaxComponent, &start, &end)) {
+            t0 = instr_now();
+            find_all_paths_visit(graph, start->row + 1, start->col + 1, end->row + 1, end->col + 1, NULL, NULL);
+            report(&gen, antennas, "all_paths", rep, instr_now() - t0);
+        }
+
+        t0 = instr_now();
+        find_intersections_visit(graph, 'A', '0', 4, NULL, NULL);
+        report(&gen, antennas, "intersections", rep, instr_now() - t0);
+
+        free_graph(graph);
+    }
+    return 0;
+}
+
+#pragma endregion
+
+#pragma region Argumentos
+
+/**
+ * Funcao para ler os argumentos da linha de comandos.
+ *
+ * \param config - configuracao a preencher
+ * \param argc - numero de argumentos
+ * \param argv - argumentos
+ * \return true se os argumentos sao validos
+ */
+static bool parse_args(BenchConfig* config, int argc, char** argv) {
+    mapgen_default_options(&config->gen);
+    config->gen.clustering = 0.3;
+    config->numSizes = 0;
+    config->reps = 3;
+    config->pathsMaxComponent = 10;
+    config->nefastoMaxAntennas = 400;
+    config->mapFile = "benchmark_map.txt";
+    config->report = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+
+        if (strcmp(arg, "--size") == 0) {
+            if (config->numSizes == MAX_SIZES) return false;
+            int r, c;
+            if (sscanf(value, "%dx%d", &r, &c) != 2 || r <= 0 || c <= 0) return false;
+            config->sizes[config->numSizes][0] = r;
+            config->sizes[config->numSizes][1] = c;
+            config->numSizes++;
+        }
+        else if (strcmp(arg, "--density") == 0) config->gen.density = atof(value);
+        else if (strcmp(arg, "--types") == 0) config->gen.numTypes = atoi(value);
+        else if (strcmp(arg, "--clustering") == 0) config->gen.clustering = atof(value);
+        else if (strcmp(arg, "--seed") == 0) config->gen.seed = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--reps") == 0) config->reps = atoi(value);
+        else if (strcmp(arg, "--paths-max-component") == 0) config->pathsMaxComponent = atoi(value);
+        else if (strcmp(arg, "--nefasto-max-antennas") == 0) config->nefastoMaxAntennas = atoi(value);
+        else if (strcmp(arg, "--map") == 0) config->mapFile = value;
+        else if (strcmp(arg, "--report") == 0) config->report = atoi(value) != 0;
+        else return false;
+        i++;
+    }
+
+    if (config->numSizes == 0) {
+        static const int defaults[][2] = { {25, 25}, {50, 50}, {100, 100}, {200, 200} };
+        config->numSizes = (int)(sizeof(defaults) / sizeof(defaults[0]));
+        memcpy(config->sizes, defaults, sizeof(defaults));
+    }
+    return config->reps > 0;
+}
+
+#pragma endregion
+
+/**
+ * @brief Funcao principal do benchmark.
+ * @return Codigo de saida do programa.
+ */
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parse_args(&config, argc, argv)) {
+        fprintf(stderr, "Uso: %s [--size RxC]... [--density D] [--types N] [--clustering C]\n"
+            "          [--seed S] [--reps N] [--paths-max-component N]\n"
+            "          [--nefasto-max-antennas N] [--map ficheiro] [--report 1]\n", argv[0]);
+        return 1;
+    }
+
+    printf("seed,rows,cols,density,types,clustering,antennas,phase,rep,seconds\n");
+    int status = 0;
+    for (int i = 0; i < config.numSizes && status == 0; i++)
+        status = run_scale(&config, config.sizes[i][0], config.sizes[i][1]);
+
+    remove(config.mapFile);
+    if (config.report) instr_report(stderr);
+    return status;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file AntennaStore.c
+ * @brief Implementacao do armazenamento compacto de antenas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AntennaStore.h"
+#include "Instrumentation.h"
+
+#define SHORT_MIN (-32768)
+#define SHORT_MAX 32767
+
+#pragma region Tabela de tipos
+
+/**
+ * Funcao para inicializar uma tabela de tipos vazia.
+ *
+ * \param table - tabela a inicializar
+ */
+void type_table_init(TypeTable* table) {
+    memset(table->idOf, NO_TYPE, sizeof(table->idOf));
+    table->count = 0;
+}
+
+/**
+ * Funcao para obter o ID de um tipo, internando-o se necessario.
+ * A frequencia do tipo e calculada uma vez, na altura do internamento.
+ *
+ * \param table - tabela de tipos
+ * \param type - caracter do tipo
+ * \return ID do tipo ou NO_TYPE se a tabela estiver cheia
+ */
+unsigned char type_table_intern(TypeTable* table, char type) {
+    unsigned char id = table->idOf[(unsigned char)type];
+    if (id != NO_TYPE) return id;
+    if (table->count == MAX_ANTENNA_TYPES) return NO_TYPE;
+
+    id = (unsigned char)table->count++;
+    table->idOf[(unsigned char)type] = id;
+    table->symbols[id] = type;
+    table->frequence[id] = get_frequence(type);
+    return id;
+}
+
+#pragma endregion
+
+#pragma region Armazenamento
+
+/**
+ * Funcao para criar um armazenamento vazio.
+ *
+ * \param initialCapacity - capacidade inicial
+ * \return armazenamento criado ou NULL se faltar memoria
+ */
+AntennaStore* store_create(int initialCapacity) {
+    AntennaStore* store = (AntennaStore*)malloc(sizeof(AntennaStore));
+    if (!store) return NULL;
+    if (initialCapacity < 16) initialCapacity = 16;
+
+    type_table_init(&store->types);
+    store->x16 = (short*)malloc(sizeof(short) * initialCapacity);
+    store->y16 = (short*)malloc(sizeof(short) * initialCapacity);
+    store->x32 = NULL;
+    store->y32 = NULL;
+    store->typeIds = (unsigned char*)malloc(initialCapacity);
+    store->count = 0;
+    store->capacity = initialCapacity;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 4);
+    if (!store->x16 || !store->y16 || !store->typeIds) {
+        store_free(store);
+        return NULL;
+    }
+    return store;
+}
+
+/**
+ * Funcao para libertar o armazenamento.
+ *
+ * \param store - armazenamento
+ */
+void store_free(AntennaStore* store) {
+    if (!store) return;
+    free(store->x16);
+    free(store->y16);
+    free(store->x32);
+    free(store->y32);
+    free(store->typeIds);
+    free(store);
+}
+
+/**
+ * Funcao para passar as coordenadas de 16 para 32 bits.
+ *
+ * \param store - armazenamento
+ * \return false se faltar memoria (as coordenadas ficam em 16 bits)
+ */
+static bool store_widen(AntennaStore* store) {
+    int* x32 = (int*)malloc(sizeof(int) * store->capacity);
+    int* y32 = (int*)malloc(sizeof(int) * store->capacity);
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    if (!x32 || !y32) {
+        free(x32);
+        free(y32);
+        return false;
+    }
+    for (int i = 0; i < store->count; i++) {
+        x32[i] = store->x16[i];
+        y32[i] = store->y16[i];
+    }
+    free(store->x16);
+    free(store->y16);
+    store->x16 = NULL;
+    store->y16 = NULL;
+    store->x32 = x32;
+    store->y32 = y32;
+    return true;
+}
+
+/**
+ * Funcao para duplicar a capacidade dos vetores.
+ * Cada vetor so e substituido depois de realocado, por isso uma falha deixa o armazenamento
+ * valido; a capacidade so aumenta quando os tres vetores cresceram.
+ *
+ * \param store - armazenamento
+ * \return false se faltar memoria
+ */
+static bool store_grow(AntennaStore* store) {
+    int capacity = store->capacity * 2;
+    if (store->x16) {
+        short* x16 = (short*)realloc(store->x16, sizeof(short) * capacity);
+        if (!x16) return false;
+        store->x16 = x16;
+        short* y16 = (short*)realloc(store->y16, sizeof(short) * capacity);
+        if (!y16) return false;
+        store->y16 = y16;
+    }
+    else {
+        int* x32 = (int*)realloc(store->x32, sizeof(int) * capacity);
+        if (!x32) return false;
+        store->x32 = x32;
+        int* y32 = (int*)realloc(store->y32, sizeof(int) * capacity);
+        if (!y32) return false;
+        store->y32 = y32;
+    }
+    unsigned char* typeIds = (unsigned char*)realloc(store->typeIds, capacity);
+    if (!typeIds) return false;
+    store->typeIds = typeIds;
+    store->capacity = capacity;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 3);
+    return true;
+}
+
+/**
+ * Funcao para acrescentar uma antena.
+ *
+ * \param store - armazenamento
+ * \param x - linha
+ * \param y - coluna
+ * \param type - tipo da antena
+ * \return indice da antena ou -1 se a tabela de tipos estiver cheia ou faltar memoria
+ */
+int store_add(AntennaStore* store, int x, int y, char type) {
+    unsigned char typeId = type_table_intern(&store->types, type);
+    if (typeId == NO_TYPE) return -1;
+
+    if (store->count == store->capacity && !store_grow(store)) return -1;
+    if (store->x16 && (x < SHORT_MIN || x > SHORT_MAX || y < SHORT_MIN || y > SHORT_MAX) &&
+        !store_widen(store))
+        return -1;
+
+    int i = store->count++;
+    if (store->x16) {
+        store->x16[i] = (short)x;
+        store->y16[i] = (short)y;
+    }
+    else {
+        store->x32[i] = x;
+        store->y32[i] = y;
+    }
+    store->typeIds[i] = typeId;
+    return i;
+}
+
+/**
+ * Funcao para obter as coordenadas e o tipo de uma antena.
+ *
+ * \param store - armazenamento
+ * \param i - indice da antena
+ * \param antenna - resultado
+ */
+void store_get(const AntennaStore* store, int i, AntennaInfo* antenna) {
+    antenna->x = store->x16 ? store->x16[i] : store->x32[i];
+    antenna->y = store->y16 ? store->y16[i] : store->y32[i];
+    antenna->type = store->types.symbols[store->typeIds[i]];
+}
+
+/**
+ * Funcao para obter a frequencia de uma antena.
+ *
+ * \param store - armazenamento
+ * \param i - indice da antena
+ * \return frequencia do tipo da antena
+ */
+double store_frequence(const AntennaStore* store, int i) {
+    return store->types.frequence[store->typeIds[i]];
+}
+
+/**
+ * Funcao para indicar se as coordenadas estao em 16 bits.
+ *
+ * \param store - armazenamento
+ * \return true se as coordenadas ocupam 16 bits
+ */
+bool store_is_compact(const AntennaStore* store) {
+    return store->x16 != NULL;
+}
+
+/**
+ * Funcao para calcular a memoria usada pelo armazenamento.
+ *
+ * \param store - armazenamento
+ * \return bytes usados
+ */
+size_t store_memory(const AntennaStore* store) {
+    size_t coordBytes = store->x16 ? sizeof(short) : sizeof(int);
+    return sizeof(AntennaStore) + (size_t)store->capacity * (2 * coordBytes + 1);
+}
+
+#pragma endregion
+
+#pragma region Conversoes
+
+/**
+ * Funcao para ler um mapa diretamente para um armazenamento compacto.
+ *
+ * \param filename - nome do ficheiro
+ * \param rows - numero de linhas lidas
+ * \param cols - numero de colunas
+ * \return armazenamento ou NULL se o ficheiro nao abrir ou faltar memoria
+ */
+AntennaStore* read_store_from_file(const char* filename, int* rows, int* cols) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        printf("Erro ao abrir ficheiro: %s\n", filename);
+        return NULL;
+    }
+
+    INSTR_PHASE_BEGIN(PHASE_PARSE);
+    AntennaStore* store = store_create(1024);
+    char line[100];
+    int y = 0;
+    *rows = 0;
+    *cols = 0;
+
+    while (store && fgets(line, sizeof(line), file)) {
+        int i;
+        for (i = 0; line[i] != '\n' && line[i] != '\0'; i++, y++) {
+            if (line[i] != '.' && store_add(store, *rows, y, line[i]) == -1) {
+                store_free(store);
+                store = NULL;
+                break;
+            }
+        }
+        if (!store) break;
+        if (line[i] == '\n') {
+            if (y > *cols) *cols = y;
+            (*rows)++;
+            y = 0;
+        }
+    }
+    if (y > 0) {
+        if (y > *cols) *cols = y;
+        (*rows)++;
+    }
+    fclose(file);
+    INSTR_PHASE_END(PHASE_PARSE);
+    return store;
+}
+
+/**
+ * Funcao para criar um armazenamento a partir de uma lista de antenas.
+ *
+ * \param root - lista de antenas
+ * \return armazenamento criado ou NULL se faltar memoria
+ */
+AntennaStore* store_from_list(Node* root) {
+    AntennaStore* store = store_create(1024);
+    for (Node* curr = root; store && curr != NULL; curr = curr->next) {
+        if (store_add(store, curr->x, curr->y, curr->type) == -1) {
+            store_free(store);
+            store = NULL;
+        }
+    }
+    return store;
+}
+
+/**
+ * Funcao para criar uma lista de antenas a partir do armazenamento.
+ * Os nos sao ligados diretamente pelo fim da lista (sem percorrer a lista em cada insercao).
+ *
+ * \param store - armazenamento
+ * \return lista de antenas
+ */
+Node* store_to_list(const AntennaStore* store) {
+    Node* root = NULL;
+    Node* tail = NULL;
+    for (int i = 0; i < store->count; i++) {
+        AntennaInfo antenna;
+        store_get(store, i, &antenna);
+
+        Node* node = (Node*)malloc(sizeof(Node));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        node->x = antenna.x;
+        node->y = antenna.y;
+        node->type = antenna.type;
+        node->next = NULL;
+        if (tail) tail->next = node;
+        else root = node;
+        tail = node;
+    }
+    return root;
+}
+
+#pragma endregion
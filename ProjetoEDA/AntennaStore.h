@@ -0,0 +1,128 @@
+/**
+ * @file AntennaStore.h
+ * @brief Armazenamento compacto de antenas para mapas com milhoes de antenas.
+ *
+ * Em vez de um Node por antena (coordenadas, tipo, ponteiro e o overhead do malloc),
+ * as antenas sao guardadas em vetores paralelos: coordenadas de 16 bits enquanto o
+ * mapa o permitir (alargadas para 32 bits quando necessario) e um ID de tipo de
+ * 1 byte. Os tipos sao internados numa TypeTable, que guarda tambem a frequencia
+ * de cada tipo, calculada uma unica vez com get_frequence.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef ANTENNA_STORE_H
+#define ANTENNA_STORE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "ListHandler.h"
+
+#pragma region Structs
+
+/** Numero maximo de tipos distintos (um ID de tipo ocupa 1 byte). */
+#define MAX_ANTENNA_TYPES 255
+
+/** ID devolvido para um tipo que nao esta na tabela. */
+#define NO_TYPE 255
+
+/**
+ * @struct TypeTable
+ * @brief Tabela de internamento de tipos: caracter <-> ID pequeno, com frequencia por tipo.
+ */
+typedef struct TypeTable {
+    unsigned char idOf[256];                 /**< Caracter -> ID (NO_TYPE se nao existir) */
+    char symbols[MAX_ANTENNA_TYPES];         /**< ID -> caracter */
+    double frequence[MAX_ANTENNA_TYPES];     /**< ID -> frequencia do tipo */
+    int count;                               /**< Numero de tipos internados */
+} TypeTable;
+
+/**
+ * @struct AntennaStore
+ * @brief Conjunto compacto de antenas em vetores paralelos.
+ */
+typedef struct AntennaStore {
+    TypeTable types;      /**< Tipos internados */
+    short* x16;           /**< Linhas em 16 bits (NULL depois de alargar) */
+    short* y16;           /**< Colunas em 16 bits (NULL depois de alargar) */
+    int* x32;             /**< Linhas em 32 bits (so depois de alargar) */
+    int* y32;             /**< Colunas em 32 bits (so depois de alargar) */
+    unsigned char* typeIds; /**< ID de tipo de cada antena */
+    int count;            /**< Numero de antenas */
+    int capacity;         /**< Capacidade dos vetores */
+} AntennaStore;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Inicializa uma tabela de tipos vazia.
+ */
+void type_table_init(TypeTable* table);
+
+/**
+ * @brief Obtem o ID de um tipo, internando-o se ainda nao existir.
+ * @return ID do tipo ou NO_TYPE se a tabela estiver cheia.
+ */
+unsigned char type_table_intern(TypeTable* table, char type);
+
+/**
+ * @brief Cria um armazenamento vazio com capacidade inicial.
+ * @return Armazenamento criado ou NULL se faltar memoria.
+ */
+AntennaStore* store_create(int initialCapacity);
+
+/**
+ * @brief Liberta o armazenamento.
+ */
+void store_free(AntennaStore* store);
+
+/**
+ * @brief Acrescenta uma antena.
+ * @return Indice da antena ou -1 se a tabela de tipos estiver cheia ou faltar memoria
+ * (o armazenamento fica como estava).
+ */
+int store_add(AntennaStore* store, int x, int y, char type);
+
+/**
+ * @brief Obtem as coordenadas e o tipo da antena de indice i.
+ */
+void store_get(const AntennaStore* store, int i, AntennaInfo* antenna);
+
+/**
+ * @brief Obtem a frequencia da antena de indice i a partir da tabela de tipos.
+ */
+double store_frequence(const AntennaStore* store, int i);
+
+/**
+ * @brief Indica se as coordenadas estao guardadas em 16 bits.
+ */
+bool store_is_compact(const AntennaStore* store);
+
+/**
+ * @brief Memoria usada pelo armazenamento, em bytes.
+ */
+size_t store_memory(const AntennaStore* store);
+
+/**
+ * @brief Le um mapa de um ficheiro diretamente para um armazenamento compacto.
+ * @return Armazenamento criado ou NULL se o ficheiro nao abrir ou faltar memoria.
+ */
+AntennaStore* read_store_from_file(const char* filename, int* rows, int* cols);
+
+/**
+ * @brief Cria um armazenamento com as antenas de uma lista (pela mesma ordem).
+ * @return Armazenamento criado ou NULL se faltar memoria.
+ */
+AntennaStore* store_from_list(Node* root);
+
+/**
+ * @brief Cria uma lista de antenas (Node) a partir do armazenamento, pela mesma ordem.
+ */
+Node* store_to_list(const AntennaStore* store);
+
+#pragma endregion
+
+#endif
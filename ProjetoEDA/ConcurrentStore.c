@@ -0,0 +1,423 @@
+/**
+ * @file ConcurrentStore.c
+ * @brief Implementacao do conjunto de antenas concorrente e da leitura paralela de mapas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#define _FILE_OFFSET_BITS 64
+#endif
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ConcurrentStore.h"
+#include "ThreadHandler.h"
+#include "Instrumentation.h"
+
+#ifdef _WIN32
+#define file_seek _fseeki64
+#define file_tell _ftelli64
+#else
+#define file_seek fseeko
+#define file_tell ftello
+#endif
+
+/* read_matrix_from_file abre o mapa em modo de texto: no Windows "\r\n" passa a '\n', nas
+   outras plataformas o '\r' fica como uma celula. As faixas sao lidas em modo binario
+   (para as posicoes serem exatas) e reproduzem o mesmo. */
+#ifdef _WIN32
+#define TEXT_MODE_CRLF true
+#else
+#define TEXT_MODE_CRLF false
+#endif
+
+/** Tamanho minimo de uma faixa do ficheiro por thread, em bytes. */
+#define MIN_SEGMENT_BYTES 65536
+
+#pragma region Structs
+
+/**
+ * @struct SegmentTask
+ * @brief Faixa do ficheiro lida por uma thread.
+ */
+typedef struct SegmentTask {
+    const char* filename;     /**< Nome do ficheiro */
+    long long start, end;     /**< Bytes [start, end) da faixa */
+    StoreWriter* writer;      /**< Escritor da thread */
+    int lines;                /**< Linhas lidas na faixa */
+    int maxCols;              /**< Maior numero de colunas de uma linha */
+    bool ok;                  /**< false se a leitura falhou */
+} SegmentTask;
+
+#pragma endregion
+
+#pragma region Conjunto concorrente
+
+/**
+ * Funcao para criar um conjunto vazio.
+ *
+ * \return conjunto criado ou NULL
+ */
+ConcurrentStore* concurrent_store_create(void) {
+    ConcurrentStore* store = (ConcurrentStore*)calloc(1, sizeof(ConcurrentStore));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    return store;
+}
+
+/**
+ * Funcao para libertar os blocos de um escritor e deixa-lo vazio.
+ *
+ * \param writer - escritor
+ */
+static void writer_clear(StoreWriter* writer) {
+    AntennaChunk* chunk = writer->first;
+    while (chunk) {
+        AntennaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    memset(writer, 0, sizeof(StoreWriter));
+}
+
+/**
+ * Funcao para obter o numero de escritores reservados.
+ *
+ * \param store - conjunto
+ * \return numero de escritores validos
+ */
+static int writer_count(ConcurrentStore* store) {
+    long count = thread_atomic_load(&store->numWriters);
+    return count < CONCURRENT_MAX_WRITERS ? (int)count : CONCURRENT_MAX_WRITERS;
+}
+
+/**
+ * Funcao para esvaziar o conjunto depois de publicado.
+ *
+ * \param store - conjunto
+ */
+static void store_reset(ConcurrentStore* store) {
+    int count = writer_count(store);
+    for (int i = 0; i < count; i++) writer_clear(&store->writers[i]);
+    thread_atomic_store(&store->numWriters, 0);
+}
+
+/**
+ * Funcao para libertar o conjunto.
+ *
+ * \param store - conjunto
+ */
+void concurrent_store_free(ConcurrentStore* store) {
+    if (!store) return;
+    store_reset(store);
+    free(store);
+}
+
+/**
+ * Funcao para reservar um escritor. O lugar e obtido com uma soma atomica, sem locks.
+ *
+ * \param store - conjunto
+ * \param order - posicao do escritor na publicacao
+ * \return escritor ou NULL
+ */
+StoreWriter* concurrent_store_writer(ConcurrentStore* store, long order) {
+    long slot = thread_atomic_add(&store->numWriters, 1);
+    if (slot >= CONCURRENT_MAX_WRITERS) return NULL;
+
+    StoreWriter* writer = &store->writers[slot];
+    memset(writer, 0, sizeof(StoreWriter));
+    writer->order = order;
+    return writer;
+}
+
+/**
+ * Funcao para acrescentar uma antena ao escritor.
+ *
+ * \param writer - escritor
+ * \param x - linha
+ * \param y - coluna
+ * \param type - tipo da antena
+ * \return false se faltar memoria
+ */
+bool store_writer_add(StoreWriter* writer, int x, int y, char type) {
+    AntennaChunk* chunk = writer->last;
+    if (!chunk || chunk->count == ANTENNA_CHUNK_SIZE) {
+        chunk = (AntennaChunk*)malloc(sizeof(AntennaChunk));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!chunk) {
+            writer->failed = true;
+            return false;
+        }
+        chunk->count = 0;
+        chunk->next = NULL;
+        if (writer->last) writer->last->next = chunk;
+        else writer->first = chunk;
+        writer->last = chunk;
+    }
+
+    AntennaInfo* antenna = &chunk->items[chunk->count++];
+    antenna->x = x;
+    antenna->y = y;
+    antenna->type = type;
+    writer->count++;
+    return true;
+}
+
+/**
+ * Funcao para ordenar os escritores pela sua posicao (ordenacao por insercao, estavel).
+ *
+ * \param store - conjunto
+ * \param order - indices dos escritores, ordenados
+ * \return numero de escritores
+ */
+static int sorted_writers(ConcurrentStore* store, int* order) {
+    int count = writer_count(store);
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        while (j > 0 && store->writers[order[j - 1]].order > store->writers[i].order) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    return count;
+}
+
+/**
+ * Funcao para publicar as antenas no fim de uma lista.
+ *
+ * \param store - conjunto
+ * \param root - lista de antenas
+ * \return numero de antenas publicadas ou -1
+ */
+long long concurrent_store_publish_list(ConcurrentStore* store, Node** root) {
+    int order[CONCURRENT_MAX_WRITERS];
+    int count = sorted_writers(store, order);
+    long long published = 0;
+    bool ok = true;
+
+    Node** tail = root;
+    while (*tail) tail = &(*tail)->next;
+
+    for (int w = 0; ok && w < count; w++) {
+        const StoreWriter* writer = &store->writers[order[w]];
+        if (writer->failed) ok = false;
+        for (const AntennaChunk* chunk = writer->first; ok && chunk; chunk = chunk->next) {
+            for (int i = 0; i < chunk->count; i++) {
+                Node* node = (Node*)malloc(sizeof(Node));
+                INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+                if (!node) {
+                    ok = false;
+                    break;
+                }
+                node->x = chunk->items[i].x;
+                node->y = chunk->items[i].y;
+                node->type = chunk->items[i].type;
+                node->next = NULL;
+                *tail = node;
+                tail = &node->next;
+                published++;
+            }
+        }
+    }
+
+    store_reset(store);
+    return ok ? published : -1;
+}
+
+/**
+ * Funcao para publicar as antenas num armazenamento compacto.
+ *
+ * \param store - conjunto
+ * \param target - armazenamento de destino
+ * \return numero de antenas publicadas ou -1
+ */
+long long concurrent_store_publish_store(ConcurrentStore* store, AntennaStore* target) {
+    int order[CONCURRENT_MAX_WRITERS];
+    int count = sorted_writers(store, order);
+    long long published = 0;
+    bool ok = true;
+
+    for (int w = 0; ok && w < count; w++) {
+        const StoreWriter* writer = &store->writers[order[w]];
+        if (writer->failed) ok = false;
+        for (const AntennaChunk* chunk = writer->first; ok && chunk; chunk = chunk->next) {
+            for (int i = 0; ok && i < chunk->count; i++) {
+                const AntennaInfo* antenna = &chunk->items[i];
+                if (store_add(target, antenna->x, antenna->y, antenna->type) == -1) ok = false;
+                else published++;
+            }
+        }
+    }
+
+    store_reset(store);
+    return ok ? published : -1;
+}
+
+#pragma endregion
+
+#pragma region Leitura paralela
+
+/**
+ * Funcao executada por cada thread: le uma faixa do ficheiro com linhas numeradas a partir de 0.
+ *
+ * \param arg - faixa a ler (SegmentTask)
+ */
+static void read_segment(void* arg) {
+    SegmentTask* task = (SegmentTask*)arg;
+    task->lines = 0;
+    task->maxCols = 0;
+    task->ok = false;
+
+    FILE* file = fopen(task->filename, "rb");
+    if (!file) return;
+    if (file_seek(file, task->start, SEEK_SET) != 0) {
+        fclose(file);
+        return;
+    }
+
+    char buffer[MIN_SEGMENT_BYTES];
+    long long remaining = task->end - task->start;
+    int row = 0, y = 0;
+    bool pendingCR = false;
+    bool ok = true;
+
+    while (ok && remaining > 0) {
+        size_t want = remaining < (long long)sizeof(buffer) ? (size_t)remaining : sizeof(buffer);
+        size_t n = fread(buffer, 1, want, file);
+        if (n == 0) break;
+        remaining -= n;
+
+        for (size_t i = 0; ok && i < n; i++) {
+            char ch = buffer[i];
+            if (pendingCR) {
+                // '\r' que nao precede '\n' e uma celula como outra qualquer
+                pendingCR = false;
+                if (ch != '\n') ok = store_writer_add(task->writer, row, y++, '\r');
+            }
+            if (TEXT_MODE_CRLF && ch == '\r') {
+                pendingCR = true;
+            }
+            else if (ch == '\n') {
+                if (y > task->maxCols) task->maxCols = y;
+                row++;
+                y = 0;
+            }
+            else {
+                if (ch != '.') ok = store_writer_add(task->writer, row, y, ch);
+                y++;
+            }
+        }
+    }
+    if (ok && pendingCR) ok = store_writer_add(task->writer, row, y++, '\r');
+    if (y > 0) {
+        if (y > task->maxCols) task->maxCols = y;
+        row++;
+    }
+    fclose(file);
+
+    task->lines = row;
+    task->ok = ok;
+}
+
+/**
+ * Funcao para encontrar o inicio da primeira linha que comeca em offset ou depois.
+ *
+ * \param file - ficheiro aberto em modo binario
+ * \param offset - posicao aproximada
+ * \param size - tamanho do ficheiro
+ * \return posicao a seguir ao primeiro '\n' em [offset - 1, size), ou size
+ */
+static long long next_line_start(FILE* file, long long offset, long long size) {
+    if (offset <= 0) return 0;
+    if (file_seek(file, offset - 1, SEEK_SET) != 0) return size;
+    int ch;
+    long long pos = offset - 1;
+    while ((ch = getc(file)) != EOF) {
+        pos++;
+        if (ch == '\n') return pos;
+    }
+    return size;
+}
+
+/**
+ * Funcao para ler um mapa com varias threads.
+ *
+ * \param filename - nome do ficheiro
+ * \param root - lista de antenas
+ * \param rows - numero de linhas lidas
+ * \param cols - numero de colunas
+ * \param numThreads - numero de threads (0 = numero de processadores)
+ * \return false se o ficheiro nao abrir ou faltar memoria
+ */
+bool read_matrix_parallel(const char* filename, Node** root, int* rows, int* cols, int numThreads) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        printf("Erro ao abrir ficheiro: %s\n", filename);
+        return false;
+    }
+
+    INSTR_PHASE_BEGIN(PHASE_PARSE);
+    file_seek(file, 0, SEEK_END);
+    long long size = file_tell(file);
+
+    if (numThreads <= 0) numThreads = thread_hardware_count();
+    if (numThreads > CONCURRENT_MAX_WRITERS) numThreads = CONCURRENT_MAX_WRITERS;
+    if (numThreads > size / MIN_SEGMENT_BYTES + 1) numThreads = (int)(size / MIN_SEGMENT_BYTES + 1);
+
+    // Cada faixa comeca no inicio de uma linha
+    SegmentTask tasks[CONCURRENT_MAX_WRITERS];
+    long long start = 0;
+    for (int t = 0; t < numThreads; t++) {
+        long long end = t == numThreads - 1 ? size : next_line_start(file, size * (t + 1) / numThreads, size);
+        if (end < start) end = start;
+        tasks[t].filename = filename;
+        tasks[t].start = start;
+        tasks[t].end = end;
+        start = end;
+    }
+    fclose(file);
+
+    ConcurrentStore* store = concurrent_store_create();
+    if (!store) {
+        INSTR_PHASE_END(PHASE_PARSE);
+        return false;
+    }
+    for (int t = 0; t < numThreads; t++) tasks[t].writer = concurrent_store_writer(store, t);
+
+    // A thread atual le a primeira faixa
+    Thread* threads[CONCURRENT_MAX_WRITERS];
+    for (int t = 1; t < numThreads; t++) threads[t] = thread_start(read_segment, &tasks[t]);
+    read_segment(&tasks[0]);
+    for (int t = 1; t < numThreads; t++) {
+        if (threads[t]) thread_join(threads[t]);
+        else read_segment(&tasks[t]);
+    }
+
+    // As linhas de cada faixa passam a ser contadas a partir do inicio do ficheiro
+    bool ok = true;
+    int rowBase = 0;
+    *rows = 0;
+    *cols = 0;
+    for (int t = 0; t < numThreads; t++) {
+        if (!tasks[t].ok) ok = false;
+        for (AntennaChunk* chunk = tasks[t].writer->first; rowBase && chunk; chunk = chunk->next) {
+            for (int i = 0; i < chunk->count; i++) chunk->items[i].x += rowBase;
+        }
+        rowBase += tasks[t].lines;
+        if (tasks[t].maxCols > *cols) *cols = tasks[t].maxCols;
+    }
+    *rows = rowBase;
+
+    if (ok && concurrent_store_publish_list(store, root) == -1) ok = false;
+    concurrent_store_free(store);
+    INSTR_PHASE_END(PHASE_PARSE);
+    return ok;
+}
+
+#pragma endregion
@@ -0,0 +1,115 @@
+/**
+ * @file ConcurrentStore.h
+ * @brief Conjunto de antenas com insercao concorrente sem locks e leitura paralela de mapas.
+ *
+ * Cada thread obtem o seu StoreWriter (um lugar reservado com uma operacao atomica) e
+ * acrescenta antenas a blocos proprios de ANTENNA_CHUNK_SIZE antenas, sem sincronizacao.
+ * Depois de todas as threads terminarem, a publicacao junta os blocos dos escritores pela
+ * ordem indicada por cada um (por exemplo, a ordem das faixas de um ficheiro) numa lista
+ * de Node ou num AntennaStore, e esvazia o conjunto para poder ser reutilizado.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef CONCURRENT_STORE_H
+#define CONCURRENT_STORE_H
+
+#include <stdbool.h>
+
+#include "ListHandler.h"
+#include "AntennaStore.h"
+
+/** Numero de antenas por bloco de um escritor. */
+#define ANTENNA_CHUNK_SIZE 1024
+
+/** Numero maximo de escritores por publicacao. */
+#define CONCURRENT_MAX_WRITERS 64
+
+#pragma region Structs
+
+/**
+ * @struct AntennaChunk
+ * @brief Bloco de antenas de um escritor.
+ */
+typedef struct AntennaChunk {
+    int count;                                /**< Antenas no bloco */
+    struct AntennaChunk* next;                /**< Bloco seguinte do mesmo escritor */
+    AntennaInfo items[ANTENNA_CHUNK_SIZE];    /**< Antenas */
+} AntennaChunk;
+
+/**
+ * @struct StoreWriter
+ * @brief Escritor de uma thread: so essa thread acrescenta antenas aos seus blocos.
+ */
+typedef struct StoreWriter {
+    long order;           /**< Posicao do escritor na publicacao */
+    AntennaChunk* first;  /**< Primeiro bloco */
+    AntennaChunk* last;   /**< Ultimo bloco (onde se acrescenta) */
+    long long count;      /**< Antenas acrescentadas */
+    bool failed;          /**< true se faltou memoria */
+} StoreWriter;
+
+/**
+ * @struct ConcurrentStore
+ * @brief Conjunto de antenas partilhado por varias threads.
+ */
+typedef struct ConcurrentStore {
+    volatile long numWriters;                     /**< Lugares de escritor reservados */
+    StoreWriter writers[CONCURRENT_MAX_WRITERS];  /**< Escritores */
+} ConcurrentStore;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Cria um conjunto vazio.
+ */
+ConcurrentStore* concurrent_store_create(void);
+
+/**
+ * @brief Liberta o conjunto e as antenas nao publicadas.
+ */
+void concurrent_store_free(ConcurrentStore* store);
+
+/**
+ * @brief Reserva um escritor para a thread atual (pode ser chamada por varias threads).
+ * @param order Posicao das antenas deste escritor na publicacao (ordem crescente).
+ * @return Escritor ou NULL se os CONCURRENT_MAX_WRITERS lugares estiverem ocupados.
+ */
+StoreWriter* concurrent_store_writer(ConcurrentStore* store, long order);
+
+/**
+ * @brief Acrescenta uma antena ao escritor. So a thread dona do escritor a pode chamar.
+ * @return false se faltar memoria.
+ */
+bool store_writer_add(StoreWriter* writer, int x, int y, char type);
+
+/**
+ * @brief Junta as antenas de todos os escritores no fim da lista, pela ordem dos escritores.
+ * So pode ser chamada depois de todas as threads escritoras terminarem.
+ * @return Numero de antenas publicadas ou -1 se faltar memoria.
+ */
+long long concurrent_store_publish_list(ConcurrentStore* store, Node** root);
+
+/**
+ * @brief Junta as antenas de todos os escritores num AntennaStore, pela ordem dos escritores.
+ * So pode ser chamada depois de todas as threads escritoras terminarem.
+ * @return Numero de antenas publicadas ou -1 em caso de erro.
+ */
+long long concurrent_store_publish_store(ConcurrentStore* store, AntennaStore* target);
+
+/**
+ * @brief Le um mapa com varias threads, cada uma com uma faixa do ficheiro cortada em fins de linha.
+ *
+ * O resultado e o mesmo de read_matrix_from_file: as antenas sao acrescentadas ao fim
+ * da lista por ordem de leitura. Como no modo de texto, "\r\n" so e fim de linha no
+ * Windows; nas outras plataformas o '\r' conta como uma celula (uma antena do tipo '\r').
+ * @param numThreads Numero de threads (0 usa o numero de processadores).
+ * @return false se o ficheiro nao abrir ou faltar memoria.
+ */
+bool read_matrix_parallel(const char* filename, Node** root, int* rows, int* cols, int numThreads);
+
+#pragma endregion
+
+#endif
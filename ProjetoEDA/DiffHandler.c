@@ -0,0 +1,615 @@
+/**
+ * @file DiffHandler.c
+ * @brief Implementacao da comparacao de revisoes de mapas e da aplicacao das alteracoes.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DiffHandler.h"
+#include "Instrumentation.h"
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+#pragma region Structs
+
+/**
+ * @struct DiffRow
+ * @brief Linha lida de uma das revisoes, com o seu hash.
+ */
+typedef struct DiffRow {
+    char* cells;              /**< Conteudo da linha */
+    int len;                  /**< Numero de colunas da linha */
+    int capacity;             /**< Capacidade alocada de cells */
+    unsigned long long hash;  /**< Hash FNV-1a do conteudo */
+} DiffRow;
+
+#pragma endregion
+
+#pragma region Leitura de linhas
+
+/**
+ * Funcao para ler a proxima linha de um ficheiro e calcular o seu hash.
+ *
+ * \param file - ficheiro aberto
+ * \param row - linha de destino
+ * \param failed - passa a true se faltar memoria
+ * \return false se nao existirem mais linhas
+ */
+static bool read_row(FILE* file, DiffRow* row, bool* failed) {
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    int len = 0;
+    int ch;
+
+    while ((ch = getc(file)) != EOF && ch != '\n') {
+        if (len == row->capacity) {
+            int capacity = row->capacity ? row->capacity * 2 : 128;
+            char* cells = (char*)realloc(row->cells, capacity);
+            if (!cells) {
+                *failed = true;
+                return false;
+            }
+            row->cells = cells;
+            row->capacity = capacity;
+            INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        }
+        row->cells[len++] = (char)ch;
+        hash = (hash ^ (unsigned char)ch) * FNV_PRIME;
+    }
+
+    row->len = len;
+    row->hash = hash;
+    return !(ch == EOF && len == 0);
+}
+
+#pragma endregion
+
+#pragma region Comparacao
+
+/**
+ * Funcao para comparar duas linhas celula a celula e entregar as alteracoes ao visitor.
+ *
+ * \param oldRow - linha da revisao antiga (len 0 se nao existir)
+ * \param newRow - linha da revisao nova (len 0 se nao existir)
+ * \param rowIndex - indice da linha (base 0)
+ * \param visitor - funcao chamada para cada evento (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \param stats - resumo da comparacao
+ */
+static void diff_rows(const DiffRow* oldRow, const DiffRow* newRow, int rowIndex,
+    MapEventVisitor visitor, void* ctx, MapDiffStats* stats) {
+    int len = oldRow->len > newRow->len ? oldRow->len : newRow->len;
+    for (int col = 0; col < len; col++) {
+        char before = col < oldRow->len ? oldRow->cells[col] : '.';
+        char after = col < newRow->len ? newRow->cells[col] : '.';
+        if (before == after) continue;
+
+        MapEvent event;
+        event.row = rowIndex;
+        event.col = col;
+        if (before != '.') {
+            event.kind = MAP_EVENT_DELETE;
+            event.type = before;
+            stats->deletes++;
+            if (visitor) visitor(&event, ctx);
+        }
+        if (after != '.') {
+            event.kind = MAP_EVENT_INSERT;
+            event.type = after;
+            stats->inserts++;
+            if (visitor) visitor(&event, ctx);
+        }
+    }
+}
+
+/**
+ * Funcao para comparar duas revisoes de um mapa.
+ *
+ * \param oldFile - ficheiro da revisao antiga
+ * \param newFile - ficheiro da revisao nova
+ * \param visitor - funcao chamada para cada evento (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \param stats - resumo da comparacao (pode ser NULL)
+ * \return false se um dos ficheiros nao abrir ou faltar memoria
+ */
+bool diff_map_files(const char* oldFile, const char* newFile, MapEventVisitor visitor, void* ctx,
+    MapDiffStats* stats) {
+    MapDiffStats local = { 0, 0, 0, 0 };
+    if (!stats) stats = &local;
+    *stats = local;
+
+    FILE* oldIn = fopen(oldFile, "r");
+    if (!oldIn) {
+        printf("Erro ao abrir ficheiro: %s\n", oldFile);
+        return false;
+    }
+    FILE* newIn = fopen(newFile, "r");
+    if (!newIn) {
+        printf("Erro ao abrir ficheiro: %s\n", newFile);
+        fclose(oldIn);
+        return false;
+    }
+
+    DiffRow oldRow = { NULL, 0, 0, 0 };
+    DiffRow newRow = { NULL, 0, 0, 0 };
+    bool failed = false;
+    bool oldMore = true, newMore = true;
+
+    while (!failed) {
+        if (oldMore) oldMore = read_row(oldIn, &oldRow, &failed);
+        if (newMore) newMore = read_row(newIn, &newRow, &failed);
+        if (failed || (!oldMore && !newMore)) break;
+        if (!oldMore) oldRow.len = 0;
+        if (!newMore) newRow.len = 0;
+
+        // Linhas com o mesmo tamanho e o mesmo hash sao saltadas sem comparar as celulas
+        if (oldMore && newMore && oldRow.len == newRow.len && oldRow.hash == newRow.hash) {
+            stats->rows++;
+            continue;
+        }
+        stats->changedRows++;
+        diff_rows(&oldRow, &newRow, stats->rows, visitor, ctx, stats);
+        stats->rows++;
+    }
+
+    free(oldRow.cells);
+    free(newRow.cells);
+    fclose(oldIn);
+    fclose(newIn);
+    return !failed;
+}
+
+#pragma endregion
+
+#pragma region Nefastos incrementais
+
+/**
+ * @struct NefastoCell
+ * @brief Posicao do mapa com antena e/ou nefastos.
+ */
+typedef struct NefastoCell {
+    int row, col;         /**< Coordenadas (base 0) */
+    int refs;             /**< Pares ordenados (a, b) do mesmo tipo com 2a - b nesta posicao */
+    int shown;            /**< Nos '#' desta posicao que estao na lista */
+    char occupant;        /**< Tipo da antena na posicao ('\0' se vazia) */
+    int position;         /**< Indice da antena no vetor do seu tipo */
+    bool used;            /**< true se a entrada da tabela esta ocupada */
+    bool dirty;           /**< true se refs ou occupant mudaram desde a ultima sincronizacao */
+} NefastoCell;
+
+/**
+ * @struct TypePositions
+ * @brief Posicoes das antenas de um tipo.
+ */
+typedef struct TypePositions {
+    int* rows;            /**< Linhas */
+    int* cols;            /**< Colunas */
+    int count;            /**< Numero de antenas */
+    int capacity;         /**< Capacidade dos vetores */
+} TypePositions;
+
+struct NefastoTracker {
+    NefastoCell* cells;           /**< Tabela de dispersao de posicoes (enderecamento aberto) */
+    int capacity;                 /**< Capacidade da tabela (potencia de 2) */
+    int used;                     /**< Entradas ocupadas */
+    TypePositions types[256];     /**< Antenas de cada tipo */
+    int* dirty;                   /**< Entradas a sincronizar com a lista */
+    int numDirty;                 /**< Numero de entradas a sincronizar */
+    int dirtyCapacity;            /**< Capacidade de dirty */
+    bool failed;                  /**< true se faltou memoria */
+};
+
+/**
+ * Funcao de dispersao para um par de coordenadas.
+ */
+static unsigned int cell_hash(int row, int col) {
+    unsigned long long key = ((unsigned long long)(unsigned int)row << 32) | (unsigned int)col;
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/**
+ * Funcao para marcar uma entrada para a proxima sincronizacao.
+ *
+ * \param tracker - estado dos nefastos
+ * \param slot - entrada da tabela
+ */
+static void mark_dirty(NefastoTracker* tracker, int slot) {
+    if (tracker->cells[slot].dirty) return;
+    if (tracker->numDirty == tracker->dirtyCapacity) {
+        int capacity = tracker->dirtyCapacity ? tracker->dirtyCapacity * 2 : 64;
+        int* dirty = (int*)realloc(tracker->dirty, sizeof(int) * capacity);
+        if (!dirty) {
+            tracker->failed = true;
+            return;
+        }
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        tracker->dirty = dirty;
+        tracker->dirtyCapacity = capacity;
+    }
+    tracker->cells[slot].dirty = true;
+    tracker->dirty[tracker->numDirty++] = slot;
+}
+
+/**
+ * Funcao para procurar a entrada de uma posicao.
+ *
+ * \param tracker - estado dos nefastos
+ * \param row - linha
+ * \param col - coluna
+ * \return entrada ou -1 se nao existir
+ */
+static int find_cell(const NefastoTracker* tracker, int row, int col) {
+    unsigned int mask = (unsigned int)tracker->capacity - 1;
+    unsigned int slot = cell_hash(row, col) & mask;
+    while (tracker->cells[slot].used) {
+        if (tracker->cells[slot].row == row && tracker->cells[slot].col == col) return (int)slot;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Funcao para duplicar a tabela de dispersao. As entradas mudam de posicao, por isso
+ * a lista das entradas a sincronizar e refeita.
+ *
+ * \param tracker - estado dos nefastos
+ * \return false se faltar memoria
+ */
+static bool grow_cells(NefastoTracker* tracker) {
+    int capacity = tracker->capacity * 2;
+    NefastoCell* cells = (NefastoCell*)calloc(capacity, sizeof(NefastoCell));
+    if (!cells) return false;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+
+    NefastoCell* old = tracker->cells;
+    int oldCapacity = tracker->capacity;
+    tracker->cells = cells;
+    tracker->capacity = capacity;
+    tracker->numDirty = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (!old[i].used) continue;
+        unsigned int slot = cell_hash(old[i].row, old[i].col) & (unsigned int)(capacity - 1);
+        while (cells[slot].used) slot = (slot + 1) & (unsigned int)(capacity - 1);
+        cells[slot] = old[i];
+        if (cells[slot].dirty) tracker->dirty[tracker->numDirty++] = (int)slot;
+    }
+    free(old);
+    return true;
+}
+
+/**
+ * Funcao para obter a entrada de uma posicao, criando-a se nao existir.
+ *
+ * \param tracker - estado dos nefastos
+ * \param row - linha
+ * \param col - coluna
+ * \return entrada ou -1 se faltar memoria
+ */
+static int get_cell(NefastoTracker* tracker, int row, int col) {
+    int found = find_cell(tracker, row, col);
+    if (found != -1) return found;
+    if ((tracker->used + 1) * 2 > tracker->capacity && !grow_cells(tracker)) {
+        tracker->failed = true;
+        return -1;
+    }
+
+    unsigned int mask = (unsigned int)tracker->capacity - 1;
+    unsigned int slot = cell_hash(row, col) & mask;
+    while (tracker->cells[slot].used) slot = (slot + 1) & mask;
+    NefastoCell* cell = &tracker->cells[slot];
+    cell->row = row;
+    cell->col = col;
+    cell->used = true;
+    tracker->used++;
+    return (int)slot;
+}
+
+/**
+ * Funcao para somar delta aos pares que geram um nefasto numa posicao.
+ */
+static void add_refs(NefastoTracker* tracker, int row, int col, int delta) {
+    int slot = get_cell(tracker, row, col);
+    if (slot == -1) return;
+    tracker->cells[slot].refs += delta;
+    mark_dirty(tracker, slot);
+}
+
+/**
+ * Funcao para atualizar as contagens com a insercao ou a remocao de uma antena.
+ * So os pares com as antenas do mesmo tipo mudam: sao percorridas apenas essas.
+ *
+ * \param tracker - estado dos nefastos
+ * \param event - evento a aplicar
+ */
+static void track_event(NefastoTracker* tracker, const MapEvent* event) {
+    if (event->type == '#') return;
+    TypePositions* positions = &tracker->types[(unsigned char)event->type];
+    int slot = get_cell(tracker, event->row, event->col);
+    if (slot == -1) return;
+
+    if (event->kind == MAP_EVENT_INSERT) {
+        if (tracker->cells[slot].occupant) return;
+        if (positions->count == positions->capacity) {
+            int capacity = positions->capacity ? positions->capacity * 2 : 16;
+            int* rows = (int*)realloc(positions->rows, sizeof(int) * capacity);
+            if (rows) positions->rows = rows;
+            int* cols = rows ? (int*)realloc(positions->cols, sizeof(int) * capacity) : NULL;
+            if (!cols) {
+                tracker->failed = true;
+                return;
+            }
+            INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+            positions->cols = cols;
+            positions->capacity = capacity;
+        }
+        tracker->cells[slot].occupant = event->type;
+        tracker->cells[slot].position = positions->count;
+        positions->rows[positions->count] = event->row;
+        positions->cols[positions->count] = event->col;
+        positions->count++;
+    }
+    else {
+        if (tracker->cells[slot].occupant != event->type) return;
+        // Troca com a ultima antena do tipo para retirar em O(1)
+        int i = tracker->cells[slot].position;
+        int last = --positions->count;
+        tracker->cells[slot].occupant = '\0';
+        if (i != last) {
+            positions->rows[i] = positions->rows[last];
+            positions->cols[i] = positions->cols[last];
+            tracker->cells[find_cell(tracker, positions->rows[i], positions->cols[i])].position = i;
+        }
+    }
+    mark_dirty(tracker, slot);
+
+    int delta = event->kind == MAP_EVENT_INSERT ? 1 : -1;
+    int count = event->kind == MAP_EVENT_INSERT ? positions->count - 1 : positions->count;
+    for (int i = 0; i < count; i++) {
+        int r = positions->rows[i], c = positions->cols[i];
+        INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+        add_refs(tracker, 2 * event->row - r, 2 * event->col - c, delta);
+        add_refs(tracker, 2 * r - event->row, 2 * c - event->col, delta);
+    }
+}
+
+/**
+ * Funcao para acertar os nos '#' da lista com as contagens das entradas alteradas.
+ * Uma posicao vazia tem refs nefastos e uma posicao com antena nao tem nenhum. Os nos a
+ * mais sao retirados numa passagem pela lista e os que faltam sao acrescentados no fim.
+ *
+ * \param tracker - estado dos nefastos
+ * \param root - ponteiro para o inicio da lista
+ * \return false se faltar memoria
+ */
+static bool sync_nefastos(NefastoTracker* tracker, Node** root) {
+    if (tracker->failed) return false;
+    if (tracker->numDirty == 0) return true;
+
+    bool surplus = false;
+    for (int i = 0; i < tracker->numDirty && !surplus; i++) {
+        const NefastoCell* cell = &tracker->cells[tracker->dirty[i]];
+        surplus = cell->shown > (cell->occupant ? 0 : cell->refs);
+    }
+
+    Node** link = root;
+    while (*link != NULL) {
+        Node* node = *link;
+        if (surplus && node->type == '#') {
+            int slot = find_cell(tracker, node->x, node->y);
+            NefastoCell* cell = slot != -1 ? &tracker->cells[slot] : NULL;
+            if (cell && cell->shown > (cell->occupant ? 0 : cell->refs)) {
+                *link = node->next;
+                free(node);
+                cell->shown--;
+                continue;
+            }
+        }
+        link = &node->next;
+    }
+
+    for (int i = 0; i < tracker->numDirty; i++) {
+        NefastoCell* cell = &tracker->cells[tracker->dirty[i]];
+        int wanted = cell->occupant ? 0 : cell->refs;
+        for (; cell->shown < wanted; cell->shown++) {
+            Node* node = (Node*)malloc(sizeof(Node));
+            if (!node) return false;
+            INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+            node->x = cell->row;
+            node->y = cell->col;
+            node->type = '#';
+            node->next = NULL;
+            *link = node;
+            link = &node->next;
+        }
+        cell->dirty = false;
+    }
+    tracker->numDirty = 0;
+    return true;
+}
+
+/**
+ * Funcao para criar o estado dos nefastos de uma lista e acertar os seus nos '#'.
+ *
+ * \param root - ponteiro para o inicio da lista
+ * \return estado criado ou NULL se faltar memoria
+ */
+NefastoTracker* nefasto_tracker_create(Node** root) {
+    NefastoTracker* tracker = (NefastoTracker*)calloc(1, sizeof(NefastoTracker));
+    if (!tracker) return NULL;
+    tracker->capacity = 1024;
+    tracker->cells = (NefastoCell*)calloc(tracker->capacity, sizeof(NefastoCell));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    if (!tracker->cells) {
+        free(tracker);
+        return NULL;
+    }
+
+    INSTR_PHASE_BEGIN(PHASE_NEFASTO);
+    for (Node* curr = *root; curr != NULL; curr = curr->next) {
+        if (curr->type == '#') {
+            int slot = get_cell(tracker, curr->x, curr->y);
+            if (slot == -1) break;
+            tracker->cells[slot].shown++;
+            mark_dirty(tracker, slot);
+            continue;
+        }
+        MapEvent event = { MAP_EVENT_INSERT, curr->x, curr->y, curr->type };
+        track_event(tracker, &event);
+    }
+    bool ok = sync_nefastos(tracker, root);
+    INSTR_PHASE_END(PHASE_NEFASTO);
+
+    if (!ok) {
+        nefasto_tracker_free(tracker);
+        return NULL;
+    }
+    return tracker;
+}
+
+/**
+ * Funcao para libertar o estado dos nefastos.
+ *
+ * \param tracker - estado dos nefastos
+ */
+void nefasto_tracker_free(NefastoTracker* tracker) {
+    if (!tracker) return;
+    for (int i = 0; i < 256; i++) {
+        free(tracker->types[i].rows);
+        free(tracker->types[i].cols);
+    }
+    free(tracker->cells);
+    free(tracker->dirty);
+    free(tracker);
+}
+
+#pragma endregion
+
+#pragma region Aplicacao de alteracoes
+
+/**
+ * Funcao para aplicar um evento a lista de antenas, procurando a partir de uma ligacao.
+ * A lista esta por ordem de linha e coluna, com os nos '#' (nefastos) no fim; a procura
+ * para no primeiro '#'. No fim, *cursor fica na ligacao da posicao do evento, por isso os
+ * eventos de uma comparacao, que chegam por ordem de linha e coluna, percorrem a lista uma so vez.
+ *
+ * \param cursor - ligacao de onde a procura comeca (as antenas antes dela vem antes do evento)
+ * \param event - evento a aplicar
+ * \return false se a posicao ja estiver ocupada (insercao), vazia (remocao) ou faltar memoria
+ */
+static bool apply_event_from(Node*** cursor, const MapEvent* event) {
+    Node** link = *cursor;
+    while (*link != NULL && (*link)->type != '#'
+        && ((*link)->x < event->row || ((*link)->x == event->row && (*link)->y < event->col)))
+        link = &(*link)->next;
+    *cursor = link;
+
+    bool exists = *link != NULL && (*link)->type != '#' && (*link)->x == event->row && (*link)->y == event->col;
+    if (event->kind == MAP_EVENT_DELETE) {
+        if (!exists) return false;
+        Node* node = *link;
+        *link = node->next;
+        free(node);
+        return true;
+    }
+
+    if (exists) return false;
+    Node* node = (Node*)malloc(sizeof(Node));
+    if (!node) return false;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    node->x = event->row;
+    node->y = event->col;
+    node->type = event->type;
+    node->next = *link;
+    *link = node;
+    return true;
+}
+
+/**
+ * Funcao para aplicar um evento a lista de antenas.
+ * As insercoes mantem a ordem de linha e coluna; os nos '#' (no fim da lista) sao ignorados.
+ *
+ * \param root - ponteiro para o inicio da lista
+ * \param event - evento a aplicar
+ * \return false se a posicao ja estiver ocupada (insercao), vazia (remocao) ou faltar memoria
+ */
+bool apply_event_to_list(Node** root, const MapEvent* event) {
+    Node** cursor = root;
+    return apply_event_from(&cursor, event);
+}
+
+/**
+ * Funcao para aplicar um evento ao grafo.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param event - evento a aplicar
+ * \return false se a posicao ja estiver ocupada (insercao), vazia (remocao) ou faltar memoria
+ */
+bool apply_event_to_graph(Graph* graph, const MapEvent* event) {
+    if (event->kind == MAP_EVENT_DELETE)
+        return graph_delete_antenna(graph, event->row, event->col) != -1;
+    return graph_insert_antenna(graph, event->row, event->col, event->type) != -1;
+}
+
+/**
+ * Contexto de apply_map_delta.
+ */
+typedef struct {
+    Node** root;              /**< Lista a atualizar (ou NULL) */
+    Node** cursor;            /**< Ligacao da lista onde parou o evento anterior */
+    Graph* graph;             /**< Grafo a atualizar (ou NULL) */
+    NefastoTracker* nefastos; /**< Nefastos da lista (ou NULL) */
+    bool failed;              /**< true se algum evento nao pode ser aplicado */
+} DeltaTarget;
+
+/**
+ * Funcao para aplicar um evento a lista e ao grafo de um DeltaTarget.
+ * Um evento que falha (falta de memoria, ou lista e grafo que nao correspondem a revisao
+ * antiga) fica registado em failed, porque a lista, o grafo e os nefastos deixam de coincidir.
+ *
+ * \param event - evento a aplicar
+ * \param ctx - DeltaTarget
+ */
+static void apply_delta_event(const MapEvent* event, void* ctx) {
+    DeltaTarget* target = (DeltaTarget*)ctx;
+    if (target->root && !apply_event_from(&target->cursor, event)) target->failed = true;
+    if (target->graph && !apply_event_to_graph(target->graph, event)) target->failed = true;
+    if (target->nefastos) {
+        INSTR_PHASE_BEGIN(PHASE_NEFASTO);
+        track_event(target->nefastos, event);
+        INSTR_PHASE_END(PHASE_NEFASTO);
+    }
+}
+
+/**
+ * Funcao para comparar duas revisoes e aplicar as alteracoes a lista e ao grafo.
+ * Os nefastos sao atualizados so nas posicoes afetadas pelos pares das antenas alteradas.
+ * Os IDs das antenas que nao mudam sao mantidos e o grafo so e alterado nas posicoes afetadas.
+ *
+ * \param oldFile - ficheiro da revisao antiga (a que foi carregada)
+ * \param newFile - ficheiro da revisao nova
+ * \param root - ponteiro para o inicio da lista (ou NULL)
+ * \param graph - ponteiro para o grafo (ou NULL)
+ * \param nefastos - estado dos nefastos da lista (ou NULL se a lista nao tem nefastos)
+ * \param stats - resumo da comparacao (pode ser NULL)
+ * \return false se um dos ficheiros nao abrir, faltar memoria ou algum evento nao puder ser aplicado
+ */
+bool apply_map_delta(const char* oldFile, const char* newFile, Node** root, Graph* graph,
+    NefastoTracker* nefastos, MapDiffStats* stats) {
+    DeltaTarget target = { root, root, graph, root ? nefastos : NULL, false };
+    bool ok = diff_map_files(oldFile, newFile, apply_delta_event, &target, stats) && !target.failed;
+
+    if (target.nefastos) {
+        INSTR_PHASE_BEGIN(PHASE_NEFASTO);
+        if (!sync_nefastos(target.nefastos, root)) ok = false;
+        INSTR_PHASE_END(PHASE_NEFASTO);
+    }
+    return ok;
+}
+
+#pragma endregion
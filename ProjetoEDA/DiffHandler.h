@@ -0,0 +1,129 @@
+/**
+ * @file DiffHandler.h
+ * @brief Diferencas entre duas revisoes de um mapa e aplicacao incremental a lista e ao grafo.
+ *
+ * Os dois ficheiros sao lidos em simultaneo, linha a linha. Cada linha e resumida por um
+ * hash FNV-1a de 64 bits; as linhas com o mesmo tamanho e o mesmo hash sao consideradas
+ * iguais e saltadas sem comparar as celulas. Nas restantes, cada celula alterada produz
+ * eventos de remocao e/ou insercao (uma troca de tipo e uma remocao seguida de uma insercao).
+ * As celulas que faltam numa linha mais curta, ou numa revisao com menos linhas, contam como '.'.
+ *
+ * A memoria usada e proporcional a linha mais longa, e nao ao mapa.
+ *
+ * Os nefastos da lista sao mantidos por um NefastoTracker, que guarda para cada posicao o
+ * numero de pares ordenados (a, b) do mesmo tipo com 2a - b nessa posicao. Inserir ou remover
+ * uma antena so altera os pares com as antenas do seu tipo, por isso cada evento custa
+ * O(antenas desse tipo) em vez de um detect_nefasto sobre o mapa inteiro.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef DIFF_HANDLER_H
+#define DIFF_HANDLER_H
+
+#include <stdbool.h>
+
+#include "ListHandler.h"
+#include "GraphHandler.h"
+
+#pragma region Structs
+
+/**
+ * @enum MapEventKind
+ * @brief Tipo de alteracao de uma celula.
+ */
+typedef enum MapEventKind {
+    MAP_EVENT_INSERT,     /**< Antena nova */
+    MAP_EVENT_DELETE      /**< Antena removida */
+} MapEventKind;
+
+/**
+ * @struct MapEvent
+ * @brief Alteracao de uma celula entre as duas revisoes.
+ */
+typedef struct MapEvent {
+    MapEventKind kind;    /**< Insercao ou remocao */
+    int row, col;         /**< Coordenadas (base 0) */
+    char type;            /**< Tipo da antena inserida ou removida */
+} MapEvent;
+
+/**
+ * @struct MapDiffStats
+ * @brief Resumo de uma comparacao.
+ */
+typedef struct MapDiffStats {
+    int rows;             /**< Linhas comparadas (as da revisao mais longa) */
+    int changedRows;      /**< Linhas com hash diferente */
+    int inserts;          /**< Eventos de insercao */
+    int deletes;          /**< Eventos de remocao */
+} MapDiffStats;
+
+/**
+ * Funcao chamada para cada evento, por ordem de linha e coluna.
+ */
+typedef void (*MapEventVisitor)(const MapEvent* event, void* ctx);
+
+/**
+ * @struct NefastoTracker
+ * @brief Contagens por posicao dos pares que geram nefastos (estrutura opaca).
+ */
+typedef struct NefastoTracker NefastoTracker;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Compara duas revisoes de um mapa e entrega cada alteracao ao visitor.
+ * @param stats Resumo da comparacao (pode ser NULL).
+ * @return false se um dos ficheiros nao abrir ou faltar memoria.
+ */
+bool diff_map_files(const char* oldFile, const char* newFile, MapEventVisitor visitor, void* ctx,
+    MapDiffStats* stats);
+
+/**
+ * @brief Aplica um evento a lista de antenas, sem mensagens.
+ * A lista tem de estar pela ordem de leitura (linha e coluna), com os nefastos no fim, como a
+ * deixam read_matrix_from_file e detect_nefasto; as insercoes mantem essa ordem.
+ * @return false se a posicao ja estiver ocupada (insercao), vazia (remocao) ou faltar memoria.
+ */
+bool apply_event_to_list(Node** root, const MapEvent* event);
+
+/**
+ * @brief Aplica um evento ao grafo com graph_insert_antenna ou graph_delete_antenna.
+ * @return false se a posicao ja estiver ocupada (insercao), vazia (remocao) ou faltar memoria.
+ */
+bool apply_event_to_graph(Graph* graph, const MapEvent* event);
+
+/**
+ * @brief Cria o estado dos nefastos de uma lista (com ou sem os nefastos de detect_nefasto).
+ * No fim a lista tem os mesmos nefastos que detect_nefasto calcularia, mas os nos '#' nao ficam
+ * necessariamente pela mesma ordem. O estado deve ser passado a apply_map_delta em todas as
+ * alteracoes seguintes da lista.
+ * @return Estado criado ou NULL se faltar memoria.
+ */
+NefastoTracker* nefasto_tracker_create(Node** root);
+
+/**
+ * @brief Liberta o estado dos nefastos (a lista nao e alterada).
+ */
+void nefasto_tracker_free(NefastoTracker* tracker);
+
+/**
+ * @brief Compara as revisoes e aplica as alteracoes a lista e ao grafo carregados da revisao antiga.
+ *
+ * Qualquer um de root e graph pode ser NULL. As antenas que nao mudam mantem os seus IDs e as novas
+ * recebem IDs novos; a ordem dos vertices e das listas de adjacencia e a de read_graph_from_file da
+ * nova revisao, por isso as travessias imprimem o mesmo, mas os IDs podem ser diferentes.
+ * @param nefastos Estado dos nefastos da lista, criado com nefasto_tracker_create (NULL se a lista
+ * nao tem nefastos). Os nos '#' das posicoes afetadas sao retirados ou acrescentados no fim da lista.
+ * @return false se um dos ficheiros nao abrir, faltar memoria ou algum evento nao puder ser aplicado
+ * (a lista ou o grafo nao correspondiam a revisao antiga); nesse caso a lista, o grafo e os nefastos
+ * podem ter ficado so em parte atualizados e devem ser lidos de novo.
+ */
+bool apply_map_delta(const char* oldFile, const char* newFile, Node** root, Graph* graph,
+    NefastoTracker* nefastos, MapDiffStats* stats);
+
+#pragma endregion
+
+#endif
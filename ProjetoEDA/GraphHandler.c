@@ -12,8 +12,10 @@
 #include <string.h>
 #include <math.h>
 #include <stdbool.h>
+#include <limits.h>
 
 #include "GraphHandler.h"
+#include "Instrumentation.h"
 
 
 #define _CRT_SECURE_NO_WARNINGS
@@ -26,9 +28,9 @@
  * \param y1 - coordenada y do primeiro ponto
  * \param x2 - coordenada x do segundo ponto
  * \param y2 - coordenada y do segundo ponto
- * \return 
+ * \return distancia
  */
-static int manhattan_distance(int x1, int y1, int x2, int y2) {
+int manhattan_distance(int x1, int y1, int x2, int y2) {
     return abs(x1 - x2) + abs(y1 - y2);
 }
 
@@ -47,6 +49,8 @@ static int manhattan_distance(int x1, int y1, int x2, int y2) {
 
 static Vertex* create_vertex(int id, int row, int col, char type) {
     Vertex* vertex = (Vertex*)malloc(sizeof(Vertex));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!vertex) return NULL;
     vertex->id = id;
     vertex->row = row;
     vertex->col = col;
@@ -59,46 +63,372 @@ static Vertex* create_vertex(int id, int row, int col, char type) {
  * Funcao para criar uma nova aresta.
  * 
  * \param destId - ID do vertice de destino
- * \return 
+ * \return aresta criada ou NULL se faltar memoria
  */
 static Edge* create_edge(int destId) {
     Edge* edge = (Edge*)malloc(sizeof(Edge));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!edge) return NULL;
     edge->destId = destId;
     edge->next = NULL;
     return edge;
 }
+#pragma endregion
+
+#pragma region Indice de coordenadas
+
+#define DENSE_INDEX_FACTOR 16
+#define EMPTY_KEY LLONG_MIN
+
 /**
- * Funcao para ler um grafo de um ficheiro.
- * 
+ * Funcao para codificar um par de coordenadas numa chave de 64 bits.
+ * O deslocamento e feito sem sinal, porque as consultas podem usar linhas negativas.
+ */
+static long long coord_key(int row, int col) {
+    return (long long)(((unsigned long long)(unsigned int)row << 32) | (unsigned int)col);
+}
+
+/**
+ * Funcao de dispersao para uma chave de coordenadas.
+ */
+static unsigned int coord_hash(long long key) {
+    unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+    return (unsigned int)(h >> 32);
+}
+
+/**
+ * Funcao para associar um ID a uma posicao no indice.
+ *
+ * \param index - ponteiro para o indice
+ * \param row - linha
+ * \param col - coluna
+ * \param id - ID do vertice (-1 para remover)
+ */
+static void index_insert(CoordIndex* index, int row, int col, int id) {
+    if (index->cells) {
+        if (row >= 0 && row < index->rows && col >= 0 && col < index->cols)
+            index->cells[(size_t)row * index->cols + col] = id;
+        return;
+    }
+
+    long long key = coord_key(row, col);
+    unsigned int mask = (unsigned int)index->capacity - 1;
+    unsigned int slot = coord_hash(key) & mask;
+    while (index->keys[slot] != EMPTY_KEY && index->keys[slot] != key)
+        slot = (slot + 1) & mask;
+    index->keys[slot] = key;
+    index->ids[slot] = id;
+}
+
+/**
+ * Funcao para obter o ID associado a uma posicao no indice.
+ *
+ * \param index - ponteiro para o indice
+ * \param row - linha
+ * \param col - coluna
+ * \return ID do vertice ou -1
+ */
+static int index_lookup(const CoordIndex* index, int row, int col) {
+    if (index->cells) {
+        if (row < 0 || row >= index->rows || col < 0 || col >= index->cols) return -1;
+        return index->cells[(size_t)row * index->cols + col];
+    }
+    if (index->capacity == 0) return -1;
+
+    long long key = coord_key(row, col);
+    unsigned int mask = (unsigned int)index->capacity - 1;
+    unsigned int slot = coord_hash(key) & mask;
+    while (index->keys[slot] != EMPTY_KEY) {
+        if (index->keys[slot] == key) return index->ids[slot];
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * Funcao para preencher o indice de coordenadas com os vertices do grafo.
+ * Usa uma tabela densa se a matriz nao for muito esparsa, senao uma tabela de dispersao.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param rows - numero de linhas da matriz
+ * \param cols - numero de colunas da matriz
+ * \param numIds - numero de IDs que o indice deve suportar
+ * \return false se faltar memoria (o indice fica vazio)
+ */
+static bool fill_index(Graph* graph, int rows, int cols, int numIds) {
+    CoordIndex* index = &graph->index;
+    index->rows = rows;
+    index->cols = cols;
+    index->cells = NULL;
+    index->keys = NULL;
+    index->ids = NULL;
+    index->capacity = 0;
+
+    long long cells = (long long)rows * cols;
+    if (cells <= (long long)DENSE_INDEX_FACTOR * numIds + 4096) {
+        index->cells = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!index->cells) return false;
+        for (long long i = 0; i < cells; i++) index->cells[i] = -1;
+    }
+    else {
+        int capacity = 16;
+        while (capacity < numIds * 2) capacity <<= 1;
+        index->capacity = capacity;
+        index->keys = (long long*)malloc(sizeof(long long) * capacity);
+        index->ids = (int*)malloc(sizeof(int) * capacity);
+        INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+        if (!index->keys || !index->ids) {
+            free(index->keys);
+            free(index->ids);
+            index->keys = NULL;
+            index->ids = NULL;
+            index->capacity = 0;
+            return false;
+        }
+        for (int i = 0; i < capacity; i++) {
+            index->keys[i] = EMPTY_KEY;
+            index->ids[i] = -1;
+        }
+    }
+
+    for (Vertex* v = graph->vertices; v != NULL; v = v->next)
+        index_insert(index, v->row, v->col, v->id);
+    return true;
+}
+
+/**
+ * Funcao para construir o indice de coordenadas, o vetor ID -> vertice e o ultimo
+ * vertice de cada linha.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param rows - numero de linhas da matriz
+ * \param cols - numero de colunas da matriz
+ */
+static void build_index(Graph* graph, int rows, int cols) {
+    graph->byId = (Vertex**)malloc(sizeof(Vertex*) * (graph->numVertices > 0 ? graph->numVertices : 1));
+    graph->rowTail = (Vertex**)calloc(rows > 0 ? rows : 1, sizeof(Vertex*));
+    graph->rowCapacity = rows;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    for (Vertex* v = graph->vertices; v != NULL; v = v->next) {
+        graph->byId[v->id] = v;
+        graph->rowTail[v->row] = v;
+    }
+
+    fill_index(graph, rows, cols, graph->numVertices);
+}
+
+/**
+ * Funcao para libertar a memoria do indice de coordenadas.
+ */
+static void free_index(CoordIndex* index) {
+    free(index->cells);
+    free(index->keys);
+    free(index->ids);
+    index->cells = NULL;
+    index->keys = NULL;
+    index->ids = NULL;
+    index->capacity = 0;
+}
+
+#pragma endregion
+
+#pragma region Kernels de vizinhanca
+
+/* Raio maximo com kernel especializado e tamanho do maior stencil correspondente. */
+#define MAX_KERNEL_RADIUS 8
+#define STENCIL_AREA(radius) (2 * (radius) * ((radius) + 1) + 1)
+#define MAX_STENCIL_AREA STENCIL_AREA(MAX_KERNEL_RADIUS)
+
+/**
+ * Kernel de vizinhanca: preenche ids/dists com os vertices do tipo indicado a distancia
+ * de Manhattan <= raio de (row, col), por ordem de linha e coluna (a ordem da lista de vertices).
+ */
+typedef int (*NeighbourKernel)(const Graph* graph, int row, int col, char type, int* ids, int* dists);
+
+/**
+ * Funcao base dos kernels de vizinhanca. E sempre chamada com um raio constante pelos
+ * kernels gerados por DEFINE_MANHATTAN_KERNEL, para que o compilador desenrole o stencil.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha do centro
+ * \param col - coluna do centro
+ * \param type - tipo procurado
+ * \param radius - raio (constante de compilacao nos kernels)
+ * \param ids - IDs encontrados
+ * \param dists - distancias correspondentes
+ * \return numero de vertices encontrados
+ */
+static inline int stencil_neighbours(const Graph* graph, int row, int col, char type, int radius,
+    int* ids, int* dists) {
+    const CoordIndex* index = &graph->index;
+    int count = 0;
+
+    for (int dr = -radius; dr <= radius; dr++) {
+        int r = row + dr;
+        int span = radius - (dr < 0 ? -dr : dr);
+        if (index->cells) {
+            if (r < 0 || r >= index->rows) continue;
+            const int* line = index->cells + (long long)r * index->cols;
+            int c0 = col - span < 0 ? 0 : col - span;
+            int c1 = col + span >= index->cols ? index->cols - 1 : col + span;
+            for (int c = c0; c <= c1; c++) {
+                int id = line[c];
+                if (id != -1 && graph->byId[id]->type == type) {
+                    ids[count] = id;
+                    dists[count] = (dr < 0 ? -dr : dr) + (c < col ? col - c : c - col);
+                    count++;
+                }
+            }
+        }
+        else {
+            for (int dc = -span; dc <= span; dc++) {
+                int id = index_lookup(index, r, col + dc);
+                if (id != -1 && graph->byId[id]->type == type) {
+                    ids[count] = id;
+                    dists[count] = (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc);
+                    count++;
+                }
+            }
+        }
+    }
+    INSTR_COUNT(INSTR_EDGES_EXAMINED, STENCIL_AREA(radius));
+    return count;
+}
+
+/* Gera um kernel de Manhattan com o raio fixo em tempo de compilacao. */
+#define DEFINE_MANHATTAN_KERNEL(RADIUS)                                                        \
+static int manhattan_kernel_r##RADIUS(const Graph* graph, int row, int col, char type,        \
+    int* ids, int* dists) {                                                                    \
+    return stencil_neighbours(graph, row, col, type, RADIUS, ids, dists);                      \
+}
+
+DEFINE_MANHATTAN_KERNEL(0)
+DEFINE_MANHATTAN_KERNEL(1)
+DEFINE_MANHATTAN_KERNEL(2)
+DEFINE_MANHATTAN_KERNEL(3)
+DEFINE_MANHATTAN_KERNEL(4)
+DEFINE_MANHATTAN_KERNEL(5)
+DEFINE_MANHATTAN_KERNEL(6)
+DEFINE_MANHATTAN_KERNEL(7)
+DEFINE_MANHATTAN_KERNEL(8)
+
+/**
+ * Funcao para escolher o kernel de vizinhanca para um raio.
+ * Devolve NULL quando nao existe kernel especializado ou quando percorrer o stencil
+ * custaria mais do que percorrer todos os vertices; nesse caso usa-se o ciclo O(V^2).
+ *
+ * \param graph - ponteiro para o grafo
+ * \param radius - raio pretendido
+ * \return kernel ou NULL
+ */
+static NeighbourKernel select_kernel(const Graph* graph, int radius) {
+    static const NeighbourKernel kernels[MAX_KERNEL_RADIUS + 1] = {
+        manhattan_kernel_r0, manhattan_kernel_r1, manhattan_kernel_r2,
+        manhattan_kernel_r3, manhattan_kernel_r4, manhattan_kernel_r5,
+        manhattan_kernel_r6, manhattan_kernel_r7, manhattan_kernel_r8
+    };
+    if (radius < 0 || radius > MAX_KERNEL_RADIUS) return NULL;
+    if (STENCIL_AREA(radius) >= graph->numVertices) return NULL;
+    return kernels[radius];
+}
+
+#pragma endregion
+
+#pragma region Leitura de grafo
+
+/**
+ * Funcao para criar as arestas de um vertice para as antenas do mesmo tipo a distancia <= radius.
+ * Os destinos sao percorridos por ordem de linha e coluna e inseridos no inicio da lista.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param source - vertice de origem
+ * \param kernel - kernel de vizinhanca para o raio (NULL percorre todos os vertices)
+ * \param radius - distancia de Manhattan maxima
+ * \return false se faltar memoria (a lista fica com as arestas criadas ate ai)
+ */
+static bool build_vertex_edges(Graph* graph, const Vertex* source, NeighbourKernel kernel, int radius) {
+    if (kernel) {
+        int ids[MAX_STENCIL_AREA], dists[MAX_STENCIL_AREA];
+        int n = kernel(graph, source->row, source->col, source->type, ids, dists);
+        for (int i = 0; i < n; i++) {
+            if (ids[i] == source->id) continue;
+            Edge* newEdge = create_edge(ids[i]);
+            if (!newEdge) return false;
+            newEdge->next = graph->adjList[source->id];
+            graph->adjList[source->id] = newEdge;
+        }
+        return true;
+    }
+
+    Vertex* target = graph->vertices;
+    while (target != NULL) {
+        INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+        if (source != target && source->type == target->type) {
+            int dist = manhattan_distance(source->row, source->col, target->row, target->col);
+            if (dist <= radius) {
+                Edge* newEdge = create_edge(target->id);
+                if (!newEdge) return false;
+                newEdge->next = graph->adjList[source->id];
+                graph->adjList[source->id] = newEdge;
+            }
+        }
+        target = target->next;
+    }
+    return true;
+}
+
+/**
+ * Funcao para criar as arestas entre antenas do mesmo tipo a distancia <= radius.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param radius - distancia de Manhattan maxima
+ */
+static void build_edges(Graph* graph, int radius) {
+    NeighbourKernel kernel = select_kernel(graph, radius);
+    for (Vertex* source = graph->vertices; source != NULL; source = source->next)
+        build_vertex_edges(graph, source, kernel, radius);
+}
+
+/**
+ * Funcao para ler os vertices de um ficheiro e criar o indice, com listas de adjacencia vazias.
+ *
  * \param filename - nome do ficheiro
  * \param rows - ponteiro para o numero de linhas
  * \param cols - ponteiro para o numero de colunas
- * \return 
+ * \return grafo sem arestas ou NULL
  */
-Graph* read_graph_from_file(const char* filename, int* rows, int* cols) {
+static Graph* read_vertices_from_file(const char* filename, int* rows, int* cols) {
     FILE* file = fopen(filename, "r");
     if (!file) {
         printf("Erro ao abrir ficheiro: %s\n", filename);
         return NULL;
     }
 
+    INSTR_PHASE_BEGIN(PHASE_PARSE);
     char line[100];
     int row = 0, colCount = 0;
     int id = 0;
 
     Graph* graph = (Graph*)malloc(sizeof(Graph));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
     graph->numVertices = 0;
     graph->vertices = NULL;
+    graph->tail = NULL;
+    graph->rowTail = NULL;
+    graph->rowCapacity = 0;
     graph->adjList = NULL;
+    graph->expanded = NULL;
 
     Vertex* tail = NULL;
 
-    // First pass: build vertex list
+    // First pass: build vertex list (long lines arrive in several chunks)
+    int col = 0;
     while (fgets(line, sizeof(line), file)) {
-        int col;
-        for (col = 0; line[col] != '\n' && line[col] != '\0'; col++) {
-            if (line[col] != '.') {
-                Vertex* newVertex = create_vertex(id++, row, col, line[col]);
+        int i;
+        for (i = 0; line[i] != '\n' && line[i] != '\0'; i++, col++) {
+            if (line[i] != '.') {
+                Vertex* newVertex = create_vertex(id++, row, col, line[i]);
                 if (graph->vertices == NULL) {
                     graph->vertices = newVertex;
                     tail = newVertex;
@@ -110,6 +440,13 @@ Graph* read_graph_from_file(const char* filename, int* rows, int* cols) {
                 graph->numVertices++;
             }
         }
+        if (line[i] == '\n') {
+            if (col > colCount) colCount = col;
+            row++;
+            col = 0;
+        }
+    }
+    if (col > 0) {
         if (col > colCount) colCount = col;
         row++;
     }
@@ -117,42 +454,99 @@ Graph* read_graph_from_file(const char* filename, int* rows, int* cols) {
 
     *rows = row;
     *cols = colCount;
+    graph->tail = tail;
+    graph->capacity = graph->numVertices;
+
+    build_index(graph, row, colCount);
+    INSTR_PHASE_END(PHASE_PARSE);
 
     // Allocate adjacency list
     graph->adjList = (Edge**)malloc(sizeof(Edge*) * graph->numVertices);
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
     for (int i = 0; i < graph->numVertices; i++)
         graph->adjList[i] = NULL;
 
+    return graph;
+}
+
+/**
+ * Funcao para ler um grafo de um ficheiro.
+ * 
+ * \param filename - nome do ficheiro
+ * \param rows - ponteiro para o numero de linhas
+ * \param cols - ponteiro para o numero de colunas
+ * \return 
+ */
+Graph* read_graph_from_file(const char* filename, int* rows, int* cols) {
+    Graph* graph = read_vertices_from_file(filename, rows, cols);
+    if (!graph) return NULL;
+
     // Second pass: build edges using Manhattan rule
-    Vertex* source = graph->vertices;
-    while (source != NULL) {
-        Vertex* target = graph->vertices;
-        while (target != NULL) {
-            if (source != target && source->type == target->type) {
-                int dist = manhattan_distance(source->row, source->col, target->row, target->col);
-                if (dist <= 4) {    
-                    Edge* newEdge = create_edge(target->id);
-                    newEdge->next = graph->adjList[source->id];
-                    graph->adjList[source->id] = newEdge;
-                }
-            }
-            target = target->next;
-        }
-        source = source->next;
-    }
+    INSTR_PHASE_BEGIN(PHASE_EDGES);
+    build_edges(graph, GRAPH_RADIUS);
+    INSTR_PHASE_END(PHASE_EDGES);
 
     return graph;
 }
+
+/**
+ * Funcao para ler um grafo de um ficheiro sem criar as arestas.
+ * As arestas de cada vertice sao criadas na primeira vez que get_neighbours o expande.
+ *
+ * \param filename - nome do ficheiro
+ * \param rows - ponteiro para o numero de linhas
+ * \param cols - ponteiro para o numero de colunas
+ * \return grafo ou NULL
+ */
+Graph* read_graph_lazy(const char* filename, int* rows, int* cols) {
+    Graph* graph = read_vertices_from_file(filename, rows, cols);
+    if (!graph) return NULL;
+
+    graph->expanded = (bool*)calloc(graph->numVertices > 0 ? graph->numVertices : 1, sizeof(bool));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    return graph;
+}
+
+/**
+ * Funcao para obter a lista de adjacencia de um vertice, criando-a se o grafo for lazy.
+ * A lista criada fica guardada no grafo; o grafo visivel (vertices e arestas) nao muda,
+ * mas a estrutura e alterada, por isso o grafo nao e const.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param id - ID do vertice
+ * \return primeira aresta do vertice
+ */
+Edge* get_neighbours(Graph* graph, int id) {
+    if (graph->expanded && !graph->expanded[id]) {
+        INSTR_PHASE_BEGIN(PHASE_EDGES);
+        build_vertex_edges(graph, graph->byId[id], select_kernel(graph, GRAPH_RADIUS), GRAPH_RADIUS);
+        INSTR_PHASE_END(PHASE_EDGES);
+        graph->expanded[id] = true;
+    }
+    return graph->adjList[id];
+}
+
+/**
+ * Funcao para criar as arestas que faltam num grafo lazy, que passa a ser um grafo normal.
+ *
+ * \param graph - ponteiro para o grafo
+ */
+void expand_graph(Graph* graph) {
+    if (!graph->expanded) return;
+    for (int id = 0; id < graph->numVertices; id++) get_neighbours(graph, id);
+    free(graph->expanded);
+    graph->expanded = NULL;
+}
 /**
  * Funcao para imprimir o grafo.
  * 
  * \param graph - ponteiro para o grafo
  */
-void print_graph(const Graph* graph) {
+void print_graph(Graph* graph) {
     Vertex* v = graph->vertices;
     while (v != NULL) {
         printf("Antenna %d [%c] at (%d, %d): ", v->id, v->type, v->row+1, v->col+1);
-        Edge* e = graph->adjList[v->id];
+        Edge* e = get_neighbours(graph, v->id);
         while (e != NULL) {
             printf("-> %d ", e->destId);
             e = e->next;
@@ -164,6 +558,257 @@ void print_graph(const Graph* graph) {
 
 #pragma endregion
 
+#pragma region Edicao do grafo
+
+/**
+ * Funcao para preparar o indice de coordenadas para mais um ID na posicao (row, col).
+ * O indice denso e recriado quando a posicao fica fora da matriz e a tabela de dispersao
+ * quando ficaria mais de meio cheia (as posicoes removidas continuam a ocupar a sua chave).
+ * A dimensao que nao chega passa pelo menos para o dobro, para que uma revisao que
+ * acrescenta linhas uma a uma nao recrie o indice em cada insercao.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \return false se faltar memoria (o indice anterior e mantido)
+ */
+static bool reserve_index(Graph* graph, int row, int col) {
+    CoordIndex* index = &graph->index;
+    int rows = row < index->rows ? index->rows : (row + 1 > 2 * index->rows ? row + 1 : 2 * index->rows);
+    int cols = col < index->cols ? index->cols : (col + 1 > 2 * index->cols ? col + 1 : 2 * index->cols);
+
+    if (index->cells) {
+        if (rows == index->rows && cols == index->cols) return true;
+    }
+    else if ((long long)(graph->numVertices + 1) * 2 <= index->capacity) {
+        index->rows = rows;
+        index->cols = cols;
+        return true;
+    }
+
+    CoordIndex old = *index;
+    if (!fill_index(graph, rows, cols, graph->numVertices + 1)) {
+        free_index(index);
+        *index = old;
+        return false;
+    }
+    free_index(&old);
+    return true;
+}
+
+/**
+ * Funcao para remover a aresta para destId de uma lista de adjacencia.
+ *
+ * \param list - ponteiro para a primeira aresta da lista
+ * \param destId - ID do destino
+ */
+static void remove_edge(Edge** list, int destId) {
+    for (Edge** link = list; *link != NULL; link = &(*link)->next) {
+        if ((*link)->destId == destId) {
+            Edge* edge = *link;
+            *link = edge->next;
+            free(edge);
+            return;
+        }
+    }
+}
+
+/**
+ * Funcao para garantir espaco para mais um ID em adjList, byId e expanded.
+ * A capacidade cresce para o dobro, por isso o custo por insercao e O(1) amortizado.
+ *
+ * \param graph - ponteiro para o grafo
+ * \return false se faltar memoria
+ */
+static bool reserve_vertex(Graph* graph) {
+    if (graph->numVertices < graph->capacity) return true;
+
+    int capacity = graph->capacity > 0 ? graph->capacity * 2 : 16;
+    Edge** adjList = (Edge**)realloc(graph->adjList, sizeof(Edge*) * capacity);
+    if (!adjList) return false;
+    graph->adjList = adjList;
+    Vertex** byId = (Vertex**)realloc(graph->byId, sizeof(Vertex*) * capacity);
+    if (!byId) return false;
+    graph->byId = byId;
+    if (graph->expanded) {
+        bool* expanded = (bool*)realloc(graph->expanded, sizeof(bool) * capacity);
+        if (!expanded) return false;
+        graph->expanded = expanded;
+    }
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    graph->capacity = capacity;
+    return true;
+}
+
+/**
+ * Funcao para garantir que rowTail tem uma posicao para a linha row.
+ * A capacidade passa pelo menos para o dobro, como as dimensoes em reserve_index.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha (base 0)
+ * \return false se faltar memoria
+ */
+static bool reserve_row(Graph* graph, int row) {
+    if (row < graph->rowCapacity) return true;
+
+    int capacity = row + 1 > 2 * graph->rowCapacity ? row + 1 : 2 * graph->rowCapacity;
+    Vertex** rowTail = (Vertex**)realloc(graph->rowTail, sizeof(Vertex*) * capacity);
+    if (!rowTail) return false;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    for (int r = graph->rowCapacity; r < capacity; r++) rowTail[r] = NULL;
+    graph->rowTail = rowTail;
+    graph->rowCapacity = capacity;
+    return true;
+}
+
+/**
+ * Funcao para comparar duas posicoes pela ordem de leitura do ficheiro (linha e coluna).
+ *
+ * \return negativo se (row1, col1) vem antes de (row2, col2), 0 se sao iguais, positivo se vem depois
+ */
+static int compare_position(int row1, int col1, int row2, int col2) {
+    if (row1 != row2) return (row1 > row2) - (row1 < row2);
+    return (col1 > col2) - (col1 < col2);
+}
+
+/**
+ * Funcao para encontrar o vertice que antecede a posicao (row, col) na lista de vertices.
+ * Parte do ultimo vertice da linha com antenas mais proxima acima (rowTail) e avanca so
+ * pelos vertices da propria linha, sem percorrer o resto do grafo.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \return vertice anterior ou NULL se a posicao fica no inicio da lista
+ */
+static Vertex* find_predecessor(const Graph* graph, int row, int col) {
+    Vertex* tail = graph->tail;
+    if (tail != NULL && compare_position(tail->row, tail->col, row, col) < 0) return tail;
+
+    Vertex* prev = NULL;
+    for (int r = (row < graph->rowCapacity ? row : graph->rowCapacity) - 1; r >= 0 && prev == NULL; r--)
+        prev = graph->rowTail[r];
+
+    Vertex* curr = prev != NULL ? prev->next : graph->vertices;
+    while (curr != NULL && curr->row == row && curr->col < col) {
+        prev = curr;
+        curr = curr->next;
+    }
+    return prev;
+}
+
+/**
+ * Funcao para inserir a aresta para id numa lista de adjacencia, na posicao em que
+ * build_vertex_edges a criaria (destinos por ordem decrescente de linha e coluna).
+ *
+ * \param graph - ponteiro para o grafo
+ * \param list - ponteiro para a primeira aresta da lista
+ * \param id - ID do destino
+ * \return false se faltar memoria
+ */
+static bool insert_edge_in_order(Graph* graph, Edge** list, int id) {
+    const Vertex* vertex = graph->byId[id];
+    Edge** link = list;
+    while (*link != NULL) {
+        const Vertex* dest = graph->byId[(*link)->destId];
+        if (compare_position(dest->row, dest->col, vertex->row, vertex->col) < 0) break;
+        link = &(*link)->next;
+    }
+    Edge* edge = create_edge(id);
+    if (!edge) return false;
+    edge->next = *link;
+    *link = edge;
+    return true;
+}
+
+/**
+ * Funcao para acrescentar uma antena ao grafo com as arestas para as antenas do mesmo tipo.
+ * A antena recebe o proximo ID e entra na lista de vertices e nas listas dos vizinhos na
+ * posicao da ordem de leitura, por isso os IDs das outras antenas nao mudam e as travessias
+ * visitam as antenas pela mesma ordem que num grafo lido do ficheiro.
+ * Se faltar memoria a meio, a antena e retirada outra vez e o grafo fica como estava.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \param type - tipo da antena
+ * \return ID da antena ou -1
+ */
+int graph_insert_antenna(Graph* graph, int row, int col, char type) {
+    if (row < 0 || col < 0 || index_lookup(&graph->index, row, col) != -1) return -1;
+
+    int id = graph->numVertices;
+    if (!reserve_vertex(graph) || !reserve_row(graph, row) || !reserve_index(graph, row, col)) return -1;
+
+    Vertex* vertex = create_vertex(id, row, col, type);
+    if (!vertex) return -1;
+    Vertex* prev = find_predecessor(graph, row, col);
+    vertex->next = prev != NULL ? prev->next : graph->vertices;
+    if (prev != NULL) prev->next = vertex;
+    else graph->vertices = vertex;
+    if (vertex->next == NULL) graph->tail = vertex;
+    if (vertex->next == NULL || vertex->next->row != row) graph->rowTail[row] = vertex;
+
+    graph->numVertices++;
+    graph->byId[id] = vertex;
+    graph->adjList[id] = NULL;
+    index_insert(&graph->index, row, col, id);
+
+    bool ok = build_vertex_edges(graph, vertex, select_kernel(graph, GRAPH_RADIUS), GRAPH_RADIUS);
+    if (graph->expanded) graph->expanded[id] = true;
+
+    // As listas dos vizinhos ja criadas recebem a aresta na posicao da ordem de leitura
+    for (Edge* edge = graph->adjList[id]; ok && edge != NULL; edge = edge->next) {
+        if (graph->expanded && !graph->expanded[edge->destId]) continue;
+        ok = insert_edge_in_order(graph, &graph->adjList[edge->destId], id);
+    }
+    if (!ok) {
+        // graph_delete_antenna retira as arestas que chegaram a ser criadas e o vertice
+        graph_delete_antenna(graph, row, col);
+        return -1;
+    }
+    return id;
+}
+
+/**
+ * Funcao para remover a antena numa posicao do grafo, com as suas arestas.
+ * O ID fica vazio (get_vertex devolve NULL) e nao volta a ser atribuido. So o no da
+ * antena removida e libertado, por isso os ponteiros para as outras antenas continuam validos.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \return ID da antena removida ou -1
+ */
+int graph_delete_antenna(Graph* graph, int row, int col) {
+    int id = index_lookup(&graph->index, row, col);
+    if (id == -1) return -1;
+
+    Edge* edge = get_neighbours(graph, id);
+    while (edge != NULL) {
+        if (!graph->expanded || graph->expanded[edge->destId])
+            remove_edge(&graph->adjList[edge->destId], id);
+        Edge* temp = edge;
+        edge = edge->next;
+        free(temp);
+    }
+    graph->adjList[id] = NULL;
+    index_insert(&graph->index, row, col, -1);
+
+    Vertex* vertex = graph->byId[id];
+    Vertex* prev = find_predecessor(graph, row, col);
+    if (prev != NULL) prev->next = vertex->next;
+    else graph->vertices = vertex->next;
+    if (graph->tail == vertex) graph->tail = prev;
+    if (graph->rowTail[row] == vertex) graph->rowTail[row] = prev != NULL && prev->row == row ? prev : NULL;
+
+    graph->byId[id] = NULL;
+    free(vertex);
+    return id;
+}
+
+#pragma endregion
+
 #pragma region Libertao de memoria
 
 /**
@@ -184,6 +829,10 @@ void free_graph(Graph* graph) {
         }
     }
     free(graph->adjList);
+    free(graph->expanded);
+    free(graph->byId);
+    free(graph->rowTail);
+    free_index(&graph->index);
 
     // Free vertices
     Vertex* vertex = graph->vertices;
@@ -200,38 +849,171 @@ void free_graph(Graph* graph) {
 
 #pragma region Busca por Profundidade e Largura
 
+/**
+ * Funcao para obter o vertice com um dado ID.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param id - ID do vertice
+ * \return ponteiro para o vertice ou NULL
+ */
+Vertex* get_vertex(const Graph* graph, int id) {
+    if (id < 0 || id >= graph->numVertices) return NULL;
+    return graph->byId[id];
+}
+
+/**
+ * Funcao para criar os buffers de trabalho para travessias sobre um grafo.
+ *
+ * \param graph - ponteiro para o grafo
+ * \return buffers criados ou NULL
+ */
+TraversalScratch* create_scratch(const Graph* graph) {
+    TraversalScratch* scratch = (TraversalScratch*)malloc(sizeof(TraversalScratch));
+    if (!scratch) return NULL;
+
+    int capacity = graph->numVertices > 0 ? graph->numVertices : 1;
+    scratch->capacity = graph->numVertices;
+    scratch->epoch = 0;
+    scratch->mark = (unsigned int*)calloc(capacity, sizeof(unsigned int));
+    scratch->dist = (int*)malloc(capacity * sizeof(int));
+    scratch->queue = (int*)malloc(capacity * sizeof(int));
+    scratch->path = (int*)malloc(capacity * sizeof(int));
+    scratch->ways = NULL;
+    scratch->waysCapacity = 0;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 5);
+
+    if (!scratch->mark || !scratch->dist || !scratch->queue || !scratch->path) {
+        free_scratch(scratch);
+        return NULL;
+    }
+    return scratch;
+}
+
+/**
+ * Funcao para libertar os buffers de trabalho.
+ *
+ * \param scratch - buffers de trabalho
+ */
+void free_scratch(TraversalScratch* scratch) {
+    if (!scratch) return;
+    free(scratch->mark);
+    free(scratch->dist);
+    free(scratch->queue);
+    free(scratch->path);
+    free(scratch->ways);
+    free(scratch);
+}
 
+/**
+ * Funcao para comecar uma nova travessia: todos os vertices passam a nao visitados.
+ * Os vetores so sao limpos quando a marca da travessia da a volta.
+ *
+ * \param scratch - buffers de trabalho
+ */
+static void begin_traversal(TraversalScratch* scratch) {
+    if (++scratch->epoch == 0) {
+        memset(scratch->mark, 0, scratch->capacity * sizeof(unsigned int));
+        scratch->epoch = 1;
+    }
+}
+
+/**
+ * Funcao para verificar se um ID pode ser usado com os buffers indicados.
+ * Os buffers criados antes de o grafo receber novas antenas deixam de ser aceites.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho
+ * \param id - ID do vertice
+ * \return true se o ID e valido
+ */
+static bool scratch_accepts(const Graph* graph, const TraversalScratch* scratch, int id) {
+    return id >= 0 && id < graph->numVertices && graph->numVertices <= scratch->capacity;
+}
+
+/**
+ * Funcao para realizar DFS a partir de um vertice, chamando o visitor para cada vertice.
+ * 
+ * \param graph - ponteiro para o grafo
+ * \param id - ID do vertice
+ * \param depth - profundidade atual
+ * \param scratch - buffers de trabalho (marcas de visita)
+ * \param visitor - funcao chamada para cada vertice (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados
+ */
+static int dfs_visit_from(Graph* graph, int id, int depth, TraversalScratch* scratch, VertexVisitor visitor, void* ctx) {
+    scratch->mark[id] = scratch->epoch;
+    int count = 1;
+    INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+
+    Vertex* vertex = get_vertex(graph, id);
+    if (!vertex) return count;
+
+    if (visitor) visitor(vertex, depth, ctx);
+
+    Edge* edge = get_neighbours(graph, id);
+    while (edge) {
+        INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+        if (scratch->mark[edge->destId] != scratch->epoch) {
+            count += dfs_visit_from(graph, edge->destId, depth + 1, scratch, visitor, ctx);
+        }
+        edge = edge->next;
+    }
+    return count;
+}
+
+/**
+ * Funcao para realizar DFS a partir de um vertice usando buffers ja alocados.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho
+ * \param startId - ID do vertice de inicio
+ * \param visitor - funcao chamada para cada vertice
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
+ */
+int dfs_visit_scratch(Graph* graph, TraversalScratch* scratch, int startId, VertexVisitor visitor, void* ctx) {
+    if (!scratch_accepts(graph, scratch, startId)) return -1;
+
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    begin_traversal(scratch);
+    int count = dfs_visit_from(graph, startId, 0, scratch, visitor, ctx);
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return count;
+}
+
+/**
+ * Funcao para realizar DFS a partir de uma antena, entregando os resultados ao visitor.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param visitor - funcao chamada para cada vertice
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
+ */
+int dfs_visit(Graph* graph, int start_row, int start_col, VertexVisitor visitor, void* ctx) {
+    int startId = find_vertex_id(graph, start_row - 1, start_col - 1);
+    if (startId == -1) return -1;
+
+    TraversalScratch* scratch = create_scratch(graph);
+    if (!scratch) return -1;
+    int count = dfs_visit_scratch(graph, scratch, startId, visitor, ctx);
+    free_scratch(scratch);
+    return count;
+}
 
 /**
- * Funcao para realizar DFS a partir de um vertice.
- * 
- * \param graph - ponteiro para o grafo
- * \param id - ID do vertice
- * \param visited - array de visitados
- * \param skip_row - linha a ignorar
- * \param skip_col - coluna a ignorar
+ * Funcao para imprimir uma antena visitada (ignora a antena de partida).
+ *
+ * \param vertex - vertice visitado
+ * \param depth - profundidade ou distancia
+ * \param ctx - nao usado
  */
-void dfs_from(Graph* graph, int id, bool* visited, int skip_row, int skip_col) {
-    if (visited[id]) return;
-    visited[id] = true;
-
-    Vertex* vertex = graph->vertices;
-    while (vertex != NULL && vertex->id != id)
-        vertex = vertex->next;
-
-    if (!vertex) return;
-
-    if (!(vertex->row == skip_row && vertex->col == skip_col)) {
-        printf("Antenna at (%d, %d) of type %c\n", vertex->row + 1, vertex->col + 1, vertex->type);
-    }
-
-    Edge* edge = graph->adjList[id];
-    while (edge) {
-        if (!visited[edge->destId]) {
-            dfs_from(graph, edge->destId, visited, skip_row, skip_col);
-        }
-        edge = edge->next;
-    }
+static void print_visited_antenna(const Vertex* vertex, int depth, void* ctx) {
+    (void)ctx;
+    if (depth == 0) return;
+    printf("Antenna at (%d, %d) of type %c\n", vertex->row + 1, vertex->col + 1, vertex->type);
 }
 
 /**
@@ -242,24 +1024,13 @@ void dfs_from(Graph* graph, int id, bool* visited, int skip_row, int skip_col) {
  * \param start_col - coluna de inicio
  */
 void dfs(Graph* graph, int start_row, int start_col) {
-	start_col--; 
-	start_row--; 
-    Vertex* vertex = graph->vertices;
-    while (vertex != NULL) {
-        if (vertex->row == start_row && vertex->col == start_col)
-            break;
-        vertex = vertex->next;
-    }
-
-    if (!vertex) {
-        printf("No antenna found at (%d, %d)\n", start_row+1 , start_col+1 );
+    if (find_vertex_id(graph, start_row - 1, start_col - 1) == -1) {
+        printf("No antenna found at (%d, %d)\n", start_row, start_col);
         return;
     }
 
-    bool* visited = (bool*)calloc(graph->numVertices, sizeof(bool));
-    printf("DFS from antenna at (%d, %d):\n", start_row+1, start_col+1);
-    dfs_from(graph, vertex->id, visited, start_row, start_col);
-    free(visited);
+    printf("DFS from antenna at (%d, %d):\n", start_row, start_col);
+    dfs_visit(graph, start_row, start_col, print_visited_antenna, NULL);
 }
 
 
@@ -271,6 +1042,7 @@ void dfs(Graph* graph, int start_row, int start_col) {
  */
 void enqueue(Queue* queue, int id) {
     QueueNode* newNode = (QueueNode*)malloc(sizeof(QueueNode));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
     newNode->id = id;
     newNode->next = NULL;
 
@@ -309,39 +1081,71 @@ bool is_empty(Queue* queue) {
     return queue->front == NULL;
 }
 /**
- * Funcao para realizar BFS a partir de um vertice.
+ * Funcao para realizar BFS a partir de um vertice usando buffers ja alocados.
+ * A fila e um vetor com um lugar por vertice, porque cada vertice entra na fila uma so vez.
  *
  * \param graph - ponteiro para o grafo
- * \param startId - ID do vertice
- * \param visited - array de visitados
- * \param skip_row - linha a ignorar
- * \param skip_col - coluna a ignorar
+ * \param scratch - buffers de trabalho
+ * \param startId - ID do vertice de inicio
+ * \param visitor - funcao chamada para cada vertice (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
  */
-void bfs_from(Graph* graph, int startId, bool* visited, int skip_row, int skip_col) {
-    Queue queue = { NULL, NULL };
-    enqueue(&queue, startId);
-    visited[startId] = true;
+int bfs_visit_scratch(Graph* graph, TraversalScratch* scratch, int startId, VertexVisitor visitor, void* ctx) {
+    if (!scratch_accepts(graph, scratch, startId)) return -1;
 
-    while (!is_empty(&queue)) {
-        int currentId = dequeue(&queue);
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    begin_traversal(scratch);
+    unsigned int epoch = scratch->epoch;
+    int* queue = scratch->queue;
+    int* dist = scratch->dist;
+    int head = 0, tail = 0;
 
-        Vertex* vertex = graph->vertices;
-        while (vertex && vertex->id != currentId)
-            vertex = vertex->next;
+    queue[tail++] = startId;
+    scratch->mark[startId] = epoch;
+    dist[startId] = 0;
 
-        if (vertex && !(vertex->row == skip_row && vertex->col == skip_col)) {
-            printf("Antenna at (%d, %d) of type %c\n", vertex->row+1, vertex->col+1, vertex->type);
-        }
+    while (head < tail) {
+        int currentId = queue[head++];
+        INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
 
-        Edge* edge = graph->adjList[currentId];
+        Vertex* vertex = get_vertex(graph, currentId);
+        if (vertex && visitor) visitor(vertex, dist[currentId], ctx);
+
+        Edge* edge = get_neighbours(graph, currentId);
         while (edge) {
-            if (!visited[edge->destId]) {
-                visited[edge->destId] = true;
-                enqueue(&queue, edge->destId);
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (scratch->mark[edge->destId] != epoch) {
+                scratch->mark[edge->destId] = epoch;
+                dist[edge->destId] = dist[currentId] + 1;
+                queue[tail++] = edge->destId;
             }
             edge = edge->next;
         }
     }
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return tail;
+}
+
+/**
+ * Funcao para realizar BFS a partir de uma antena, entregando os resultados ao visitor.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param visitor - funcao chamada para cada vertice
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
+ */
+int bfs_visit(Graph* graph, int start_row, int start_col, VertexVisitor visitor, void* ctx) {
+    int startId = find_vertex_id(graph, start_row - 1, start_col - 1);
+    if (startId == -1) return -1;
+
+    TraversalScratch* scratch = create_scratch(graph);
+    if (!scratch) return -1;
+    int count = bfs_visit_scratch(graph, scratch, startId, visitor, ctx);
+    free_scratch(scratch);
+    return count;
 }
 
 /**
@@ -352,24 +1156,130 @@ void bfs_from(Graph* graph, int startId, bool* visited, int skip_row, int skip_c
  * \param start_col - coluna de inicio
  */
 void bfs(Graph* graph, int start_row, int start_col) {
-	start_col--;
-	start_row--;
-    Vertex* vertex = graph->vertices;
-    while (vertex) {
-        if (vertex->row == start_row && vertex->col == start_col)
-            break;
-        vertex = vertex->next;
+    if (find_vertex_id(graph, start_row - 1, start_col - 1) == -1) {
+        printf("No antenna found at (%d, %d)\n", start_row, start_col);
+        return;
     }
 
-    if (!vertex) {
-        printf("No antenna found at (%d, %d)\n", start_row+1 , start_col+1 );
-        return;
+    printf("BFS from antenna at (%d, %d):\n", start_row, start_col);
+    bfs_visit(graph, start_row, start_col, print_visited_antenna, NULL);
+}
+
+/**
+ * Contexto usado para recolher IDs e distancias para arrays do chamador.
+ */
+typedef struct {
+    int* ids;
+    int* dists;
+    int maxIds;
+    int count;
+} CollectContext;
+
+/**
+ * Funcao para guardar um vertice visitado nos arrays do chamador.
+ *
+ * \param vertex - vertice visitado
+ * \param depth - profundidade ou distancia
+ * \param ctx - contexto de recolha
+ */
+static void collect_vertex(const Vertex* vertex, int depth, void* ctx) {
+    CollectContext* collect = (CollectContext*)ctx;
+    if (collect->count < collect->maxIds) {
+        if (collect->ids) collect->ids[collect->count] = vertex->id;
+        if (collect->dists) collect->dists[collect->count] = depth;
+    }
+    collect->count++;
+}
+
+/**
+ * Funcao para recolher os IDs visitados por uma DFS.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param ids - array de saida
+ * \param maxIds - capacidade do array
+ * \return numero de vertices visitados ou -1
+ */
+int dfs_collect(Graph* graph, int start_row, int start_col, int* ids, int maxIds) {
+    CollectContext collect = { ids, NULL, maxIds, 0 };
+    return dfs_visit(graph, start_row, start_col, collect_vertex, &collect);
+}
+
+/**
+ * Funcao para recolher os IDs e distancias visitados por uma BFS.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param ids - array de saida
+ * \param dists - array de distancias (pode ser NULL)
+ * \param maxIds - capacidade dos arrays
+ * \return numero de vertices visitados ou -1
+ */
+int bfs_collect(Graph* graph, int start_row, int start_col, int* ids, int* dists, int maxIds) {
+    CollectContext collect = { ids, dists, maxIds, 0 };
+    return bfs_visit(graph, start_row, start_col, collect_vertex, &collect);
+}
+
+/**
+ * Funcao para calcular, numa so BFS, a distancia de cada vertice a origem mais proxima.
+ * A fila comeca com todas as origens (distancia 0), pela ordem dada; como a fila mantem
+ * as origens por essa ordem em cada nivel, um empate fica para a origem que aparece primeiro.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param sourceIds - IDs das origens
+ * \param numSources - numero de origens
+ * \param dist - distancia a origem mais proxima (-1 se inalcancavel)
+ * \param nearest - ID da origem mais proxima (-1 se inalcancavel), pode ser NULL
+ * \return numero de vertices alcancados ou -1
+ */
+int multi_source_bfs(Graph* graph, const int* sourceIds, int numSources, int* dist, int* nearest) {
+    for (int i = 0; i < numSources; i++) {
+        if (sourceIds[i] < 0 || sourceIds[i] >= graph->numVertices) return -1;
+    }
+
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    for (int id = 0; id < graph->numVertices; id++) {
+        dist[id] = -1;
+        if (nearest) nearest[id] = -1;
+    }
+
+    int* queue = (int*)malloc((graph->numVertices > 0 ? graph->numVertices : 1) * sizeof(int));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!queue) {
+        INSTR_PHASE_END(PHASE_TRAVERSAL);
+        return -1;
+    }
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < numSources; i++) {
+        int id = sourceIds[i];
+        if (dist[id] != -1) continue; // origem repetida
+        dist[id] = 0;
+        if (nearest) nearest[id] = id;
+        queue[tail++] = id;
+    }
+
+    while (head < tail) {
+        int currentId = queue[head++];
+        INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+
+        Edge* edge = get_neighbours(graph, currentId);
+        while (edge) {
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (dist[edge->destId] == -1) {
+                dist[edge->destId] = dist[currentId] + 1;
+                if (nearest) nearest[edge->destId] = nearest[currentId];
+                queue[tail++] = edge->destId;
+            }
+            edge = edge->next;
+        }
     }
 
-    bool* visited = (bool*)calloc(graph->numVertices, sizeof(bool));
-    printf("BFS from antenna at (%d, %d):\n", start_row+1 , start_col+1);
-    bfs_from(graph, vertex->id, visited, start_row, start_col);
-    free(visited);
+    free(queue);
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return tail;
 }
 
 #pragma endregion
@@ -385,14 +1295,7 @@ void bfs(Graph* graph, int start_row, int start_col) {
  * \return
  */
 int find_vertex_id(Graph* graph, int row, int col) {
-    Vertex* vertex = graph->vertices;
-    while (vertex != NULL) {
-        if (vertex->row == row && vertex->col == col) {
-            return vertex->id;
-        }
-        vertex = vertex->next;
-    }
-    return -1; 
+    return index_lookup(&graph->index, row, col);
 }
 
 #pragma endregion
@@ -404,36 +1307,105 @@ int find_vertex_id(Graph* graph, int row, int col) {
  * \param graph - ponteiro para o grafo
  * \param currentId - ID do vertice atual
  * \param endId - ID do vertice de destino
- * \param visited - array de visitados
+ * \param scratch - buffers de trabalho (marcas de visita)
  * \param path - array de caminhos
  * \param pathLen - comprimento do caminho
+ * \param visitor - funcao chamada para cada caminho (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de caminhos encontrados
  */
-void dfs_all_paths(Graph* graph, int currentId, int endId, bool* visited, int* path, int pathLen) {
-    visited[currentId] = true;
+static int dfs_all_paths(Graph* graph, int currentId, int endId, TraversalScratch* scratch, int* path, int pathLen,
+    PathVisitor visitor, void* ctx) {
+    int count = 0;
+    scratch->mark[currentId] = scratch->epoch;
     path[pathLen++] = currentId;
+    INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
 
     if (currentId == endId) {
-        // Print current path
-        printf("Path: ");
-        for (int i = 0; i < pathLen; i++) {
-            Vertex* vertex = graph->vertices;
-            while (vertex && vertex->id != path[i]) vertex = vertex->next;
-            if (vertex) printf("(%d,%d)%s", vertex->row + 1, vertex->col + 1, i == pathLen - 1 ? "" : " -> ");
-        }
-        printf("\n");
+        if (visitor) visitor(graph, path, pathLen, ctx);
+        INSTR_COUNT(INSTR_PATHS_EMITTED, 1);
+        count = 1;
     }
     else {
-        Edge* edge = graph->adjList[currentId];
+        Edge* edge = get_neighbours(graph, currentId);
         while (edge) {
-            if (!visited[edge->destId]) {
-                dfs_all_paths(graph, edge->destId, endId, visited, path, pathLen);
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (scratch->mark[edge->destId] != scratch->epoch) {
+                count += dfs_all_paths(graph, edge->destId, endId, scratch, path, pathLen, visitor, ctx);
             }
             edge = edge->next;
         }
     }
 
-    visited[currentId] = false; // backtrack
+    scratch->mark[currentId] = 0; // backtrack
+    return count;
+}
+
+/**
+ * Funcao para enumerar todos os caminhos entre dois vertices usando buffers ja alocados.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho
+ * \param startId - ID do vertice de inicio
+ * \param endId - ID do vertice de destino
+ * \param visitor - funcao chamada para cada caminho
+ * \param ctx - contexto passado ao visitor
+ * \return numero de caminhos encontrados ou -1
+ */
+int find_all_paths_scratch(Graph* graph, TraversalScratch* scratch, int startId, int endId,
+    PathVisitor visitor, void* ctx) {
+    if (!scratch_accepts(graph, scratch, startId) || !scratch_accepts(graph, scratch, endId)) return -1;
+
+    INSTR_PHASE_BEGIN(PHASE_PATHS);
+    begin_traversal(scratch);
+    int count = dfs_all_paths(graph, startId, endId, scratch, scratch->path, 0, visitor, ctx);
+    INSTR_PHASE_END(PHASE_PATHS);
+    return count;
+}
+
+/**
+ * Funcao para enumerar todos os caminhos entre duas antenas, entregando cada um ao visitor.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param end_row - linha de destino
+ * \param end_col - coluna de destino
+ * \param visitor - funcao chamada para cada caminho
+ * \param ctx - contexto passado ao visitor
+ * \return numero de caminhos encontrados ou -1
+ */
+int find_all_paths_visit(Graph* graph, int start_row, int start_col, int end_row, int end_col,
+    PathVisitor visitor, void* ctx) {
+    int startId = find_vertex_id(graph, start_row - 1, start_col - 1);
+    int endId = find_vertex_id(graph, end_row - 1, end_col - 1);
+    if (startId == -1 || endId == -1) return -1;
+
+    TraversalScratch* scratch = create_scratch(graph);
+    if (!scratch) return -1;
+    int count = find_all_paths_scratch(graph, scratch, startId, endId, visitor, ctx);
+    free_scratch(scratch);
+    return count;
+}
+
+/**
+ * Funcao para imprimir um caminho encontrado.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param path - sequencia de IDs
+ * \param pathLen - comprimento do caminho
+ * \param ctx - nao usado
+ */
+static void print_path(const Graph* graph, const int* path, int pathLen, void* ctx) {
+    (void)ctx;
+    printf("Path: ");
+    for (int i = 0; i < pathLen; i++) {
+        Vertex* vertex = get_vertex(graph, path[i]);
+        if (vertex) printf("(%d,%d)%s", vertex->row + 1, vertex->col + 1, i == pathLen - 1 ? "" : " -> ");
+    }
+    printf("\n");
 }
+
 /**
  * Funcao para encontrar todos os caminhos entre dois vertices.
  *
@@ -444,54 +1416,381 @@ void dfs_all_paths(Graph* graph, int currentId, int endId, bool* visited, int* p
  * \param end_col - coluna de destino
  */
 void find_all_paths(Graph* graph, int start_row, int start_col, int end_row, int end_col) {
-	start_col--;
-	start_row--;
-	end_col--;
-	end_row--;
-    int startId = find_vertex_id(graph, start_row, start_col);
-    int endId = find_vertex_id(graph, end_row, end_col);
-
-    if (startId == -1 || endId == -1) {
+    if (find_vertex_id(graph, start_row - 1, start_col - 1) == -1 ||
+        find_vertex_id(graph, end_row - 1, end_col - 1) == -1) {
         printf("One or both antennas not found.\n");
         return;
     }
 
-    bool* visited = (bool*)calloc(graph->numVertices, sizeof(bool));
-    int* path = (int*)malloc(graph->numVertices * sizeof(int));
+    printf("All paths from (%d,%d) to (%d,%d):\n", start_row, start_col, end_row, end_col);
+    find_all_paths_visit(graph, start_row, start_col, end_row, end_col, print_path, NULL);
+}
+
+#pragma endregion
+
+#pragma region Estatisticas de Caminhos
 
-    printf("All paths from (%d,%d) to (%d,%d):\n", start_row + 1, start_col + 1, end_row + 1, end_col + 1);
-    dfs_all_paths(graph, startId, endId, visited, path, 0);
+/**
+ * Contexto da enumeracao podada usada por find_path_stats.
+ * Um vertice esta no caminho atual quando scratch->mark[id] == scratch->epoch.
+ */
+typedef struct {
+    Graph* graph;
+    TraversalScratch* scratch;
+    int endId;
+    int maxHops;
+    const int* distToEnd;
+    PathStats* stats;
+} PathSearch;
 
-    free(visited);
-    free(path);
+/**
+ * Funcao para registar caminhos com um dado numero de saltos nas estatisticas.
+ *
+ * \param stats - estatisticas
+ * \param hops - numero de saltos
+ * \param count - numero de caminhos
+ */
+static void record_paths(PathStats* stats, int hops, long long count) {
+    stats->count += count;
+    if (stats->shortest == -1 || hops < stats->shortest) stats->shortest = hops;
+    if (hops > stats->longest) stats->longest = hops;
+    INSTR_COUNT(INSTR_PATHS_EMITTED, count);
 }
+
 /**
- * Funcao para encontrar interseccoes entre dois tipos de antenas.
+ * Funcao para contar os caminhos a partir de um vertice, sem os guardar.
+ * Um ramo e cortado quando o destino ja nao e alcancavel dentro do limite de saltos.
+ *
+ * \param search - contexto da enumeracao
+ * \param currentId - ID do vertice atual
+ * \param hops - saltos ate ao vertice atual
+ */
+static void count_paths_from(PathSearch* search, int currentId, int hops) {
+    INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+    if (currentId == search->endId) {
+        record_paths(search->stats, hops, 1);
+        return;
+    }
+
+    TraversalScratch* scratch = search->scratch;
+    scratch->mark[currentId] = scratch->epoch;
+    Edge* edge = get_neighbours(search->graph, currentId);
+    while (edge) {
+        INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+        int next = edge->destId;
+        if (scratch->mark[next] != scratch->epoch &&
+            (search->maxHops < 0 || hops + 1 + search->distToEnd[next] <= search->maxHops)) {
+            count_paths_from(search, next, hops + 1);
+        }
+        edge = edge->next;
+    }
+    scratch->mark[currentId] = 0; // backtrack
+}
+
+/**
+ * Funcao para contar os bits a 1 de uma mascara.
+ */
+static int count_bits(unsigned int mask) {
+    int bits = 0;
+    for (; mask; mask &= mask - 1) bits++;
+    return bits;
+}
+
+/**
+ * Funcao para obter a tabela da programacao dinamica a zero, reutilizando a dos buffers.
+ *
+ * \param scratch - buffers de trabalho
+ * \param count - numero de contadores
+ * \return tabela ou NULL se faltar memoria
+ */
+static long long* dp_table(TraversalScratch* scratch, size_t count) {
+    if (scratch->waysCapacity < count) {
+        long long* ways = (long long*)realloc(scratch->ways, count * sizeof(long long));
+        if (!ways) return NULL;
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        scratch->ways = ways;
+        scratch->waysCapacity = count;
+    }
+    memset(scratch->ways, 0, count * sizeof(long long));
+    return scratch->ways;
+}
+
+/**
+ * Funcao para obter o indice de um vertice em members na programacao dinamica.
+ * Os membros estao marcados com a travessia atual e o indice esta em scratch->dist.
+ *
+ * \param scratch - buffers de trabalho
+ * \param id - ID do vertice
+ * \return indice ou -1 se o vertice nao e membro
+ */
+static int member_index(const TraversalScratch* scratch, int id) {
+    return scratch->mark[id] == scratch->epoch ? scratch->dist[id] : -1;
+}
+
+/**
+ * Funcao para contar caminhos por programacao dinamica sobre subconjuntos de vertices.
+ * ways[mask][v] e o numero de caminhos simples que comecam na origem, passam exatamente
+ * pelos vertices de mask e terminam em v; o numero de saltos e |mask| - 1.
+ * A origem e o indice 0, por isso so as mascaras impares sao usadas e a tabela guarda
+ * apenas essas (k * 2^(k-1) contadores).
  *
  * \param graph - ponteiro para o grafo
- * \param typeA - tipo da antena A
- * \param typeB - tipo da antena B
- * \param maxDistance - distancia maxima
+ * \param scratch - buffers de trabalho com a tabela a reutilizar e os indices dos membros
+ * \param members - IDs dos vertices considerados (members[0] e a origem)
+ * \param k - numero de vertices (<= PATH_DP_MAX_VERTICES)
+ * \param endId - ID do destino
+ * \param maxHops - limite de saltos (< 0 sem limite)
+ * \param stats - estatisticas
+ * \return false se faltar memoria
+ */
+static bool count_paths_dp(Graph* graph, TraversalScratch* scratch, const int* members, int k,
+    int endId, int maxHops, PathStats* stats) {
+    long long* ways = dp_table(scratch, (size_t)k << (k - 1));
+    unsigned int adjacent[PATH_DP_MAX_VERTICES];
+    if (!ways) return false;
+
+    for (int i = 0; i < k; i++) {
+        adjacent[i] = 0;
+        for (Edge* edge = get_neighbours(graph, members[i]); edge; edge = edge->next) {
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            int local = member_index(scratch, edge->destId);
+            if (local != -1) adjacent[i] |= 1u << local;
+        }
+    }
+
+    int end = member_index(scratch, endId);
+    ways[0] = 1;
+
+    for (unsigned int mask = 1; mask < (1u << k); mask += 2) {
+        int hops = count_bits(mask) - 1;
+        for (int v = 0; v < k; v++) {
+            long long count = ways[(size_t)(mask >> 1) * k + v];
+            if (count == 0) continue;
+            if (v == end) {
+                record_paths(stats, hops, count);
+                continue;
+            }
+            if (maxHops >= 0 && hops + 1 > maxHops) continue;
+            unsigned int unvisited = adjacent[v] & ~mask;
+            for (int w = 0; w < k; w++) {
+                if (unvisited & (1u << w)) ways[(size_t)((mask | (1u << w)) >> 1) * k + w] += count;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Funcao para calcular a distancia em saltos de um vertice a todos os que alcanca.
+ * Comeca uma nova travessia: no fim, os vertices alcancados tem mark[id] == epoch e estao
+ * em scratch->queue, e so as suas posicoes de dist sao escritas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho (marcas e fila)
+ * \param startId - ID da origem
+ * \param dist - distancia de cada vertice alcancado
+ * \return numero de vertices alcancados
+ */
+static int reach_distances(Graph* graph, TraversalScratch* scratch, int startId, int* dist) {
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    begin_traversal(scratch);
+    unsigned int epoch = scratch->epoch;
+    int* queue = scratch->queue;
+    int head = 0, tail = 0;
+
+    queue[tail++] = startId;
+    scratch->mark[startId] = epoch;
+    dist[startId] = 0;
+
+    while (head < tail) {
+        int currentId = queue[head++];
+        INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+        for (Edge* edge = get_neighbours(graph, currentId); edge; edge = edge->next) {
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (scratch->mark[edge->destId] != epoch) {
+                scratch->mark[edge->destId] = epoch;
+                dist[edge->destId] = dist[currentId] + 1;
+                queue[tail++] = edge->destId;
+            }
+        }
+    }
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return tail;
+}
+
+/**
+ * Funcao para calcular as estatisticas dos caminhos entre dois vertices.
+ * Todo o trabalho fica limitado a componente da origem: a distancia a partir da origem fica
+ * em scratch->dist e a distancia ate ao destino em scratch->path, e so os vertices
+ * alcancados sao percorridos.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho
+ * \param startId - ID da origem
+ * \param endId - ID do destino
+ * \param maxHops - limite de saltos (< 0 sem limite)
+ * \param stats - estatisticas calculadas
+ */
+static void path_stats_between(Graph* graph, TraversalScratch* scratch, int startId, int endId, int maxHops,
+    PathStats* stats) {
+    stats->count = 0;
+    stats->shortest = -1;
+    stats->longest = -1;
+
+    int* distFromStart = scratch->dist;
+    int* distToEnd = scratch->path;
+    reach_distances(graph, scratch, startId, distFromStart);
+    if (scratch->mark[endId] != scratch->epoch) return;
+    if (maxHops >= 0 && distFromStart[endId] > maxHops) return;
+    // As arestas sao simetricas: a BFS a partir do destino alcanca a mesma componente
+    int reached = reach_distances(graph, scratch, endId, distToEnd);
+
+    INSTR_PHASE_BEGIN(PHASE_PATHS);
+    // Vertices que podem estar num caminho dentro do limite; a origem fica no indice 0
+    int members[PATH_DP_MAX_VERTICES];
+    int k = 1;
+    members[0] = startId;
+    for (int i = 0; i < reached; i++) {
+        int id = scratch->queue[i];
+        if (id == startId) continue;
+        if (maxHops >= 0 && distFromStart[id] + distToEnd[id] > maxHops) continue;
+        if (k < PATH_DP_MAX_VERTICES) members[k] = id;
+        k++;
+    }
+
+    bool counted = false;
+    if (k <= PATH_DP_MAX_VERTICES) {
+        // Os membros sao marcados com uma nova travessia e o seu indice fica em dist
+        begin_traversal(scratch);
+        for (int i = 0; i < k; i++) {
+            scratch->mark[members[i]] = scratch->epoch;
+            scratch->dist[members[i]] = i;
+        }
+        counted = count_paths_dp(graph, scratch, members, k, endId, maxHops, stats);
+    }
+    if (!counted) {
+        begin_traversal(scratch);
+        PathSearch search = { graph, scratch, endId, maxHops, distToEnd, stats };
+        count_paths_from(&search, startId, 0);
+    }
+    INSTR_PHASE_END(PHASE_PATHS);
+}
+
+/**
+ * Funcao para calcular as estatisticas dos caminhos entre duas antenas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param end_row - linha de destino
+ * \param end_col - coluna de destino
+ * \param maxHops - limite de saltos (< 0 sem limite)
+ * \param stats - estatisticas calculadas
+ * \return 0 ou -1 se alguma antena nao existir ou faltar memoria
+ */
+int find_path_stats(Graph* graph, int start_row, int start_col, int end_row, int end_col, int maxHops,
+    PathStats* stats) {
+    int startId = find_vertex_id(graph, start_row - 1, start_col - 1);
+    int endId = find_vertex_id(graph, end_row - 1, end_col - 1);
+    if (startId == -1 || endId == -1) return -1;
+
+    TraversalScratch* scratch = create_scratch(graph);
+    if (!scratch) return -1;
+    path_stats_between(graph, scratch, startId, endId, maxHops, stats);
+    free_scratch(scratch);
+    return 0;
+}
+
+/**
+ * Funcao para calcular as estatisticas dos caminhos entre dois vertices, reutilizando os
+ * buffers: nada e alocado por consulta, exceto quando a tabela da programacao dinamica cresce.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de trabalho
+ * \param startId - ID da origem
+ * \param endId - ID do destino
+ * \param maxHops - limite de saltos (< 0 sem limite)
+ * \param stats - estatisticas calculadas
+ * \return 0 ou -1 se algum ID for invalido
+ */
+int find_path_stats_scratch(Graph* graph, TraversalScratch* scratch, int startId, int endId, int maxHops,
+    PathStats* stats) {
+    if (!scratch_accepts(graph, scratch, startId) || !scratch_accepts(graph, scratch, endId)) return -1;
+    if (!graph->byId[startId] || !graph->byId[endId]) return -1;
+
+    path_stats_between(graph, scratch, startId, endId, maxHops, stats);
+    return 0;
+}
+
+/**
+ * Funcao para imprimir as estatisticas dos caminhos entre duas antenas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param start_row - linha de inicio
+ * \param start_col - coluna de inicio
+ * \param end_row - linha de destino
+ * \param end_col - coluna de destino
+ * \param maxHops - limite de saltos (< 0 sem limite)
  */
+void print_path_stats(Graph* graph, int start_row, int start_col, int end_row, int end_col, int maxHops) {
+    PathStats stats;
+    if (find_path_stats(graph, start_row, start_col, end_row, end_col, maxHops, &stats) == -1) {
+        printf("One or both antennas not found.\n");
+        return;
+    }
+
+    printf("Path statistics from (%d,%d) to (%d,%d):\n", start_row, start_col, end_row, end_col);
+    printf("  Paths: %lld\n", stats.count);
+    printf("  Shortest: %d\n", stats.shortest);
+    printf("  Longest: %d\n", stats.longest);
+}
 
 #pragma endregion
 
 #pragma region Intersecoes
 
-void find_intersections(Graph* graph, char typeA, char typeB, int maxDistance) {
+/**
+ * Funcao para encontrar interseccoes entre dois tipos de antenas, entregando cada uma ao visitor.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param typeA - tipo da antena A
+ * \param typeB - tipo da antena B
+ * \param maxDistance - distancia maxima
+ * \param visitor - funcao chamada para cada intersecao (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de intersecoes encontradas
+ */
+int find_intersections_visit(Graph* graph, char typeA, char typeB, int maxDistance,
+    IntersectionVisitor visitor, void* ctx) {
+    int count = 0;
     Vertex* source = graph->vertices;
+    INSTR_PHASE_BEGIN(PHASE_INTERSECTIONS);
+
+    NeighbourKernel kernel = select_kernel(graph, maxDistance);
+    if (kernel) {
+        int ids[MAX_STENCIL_AREA], dists[MAX_STENCIL_AREA];
+        for (; source != NULL; source = source->next) {
+            if (source->type != typeA) continue;
+            int n = kernel(graph, source->row, source->col, typeB, ids, dists);
+            for (int i = 0; i < n; i++) {
+                if (visitor) visitor(source, graph->byId[ids[i]], dists[i], ctx);
+                count++;
+            }
+        }
+        INSTR_PHASE_END(PHASE_INTERSECTIONS);
+        return count;
+    }
 
     while (source != NULL) {
         if (source->type == typeA) {
             Vertex* target = graph->vertices;
             while (target != NULL) {
+                INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
                 if (target->type == typeB) {
-                    int dist = abs(source->row - target->row) + abs(source->col - target->col);
+                    int dist = manhattan_distance(source->row, source->col, target->row, target->col);
                     if (dist <= maxDistance) {
-                        printf("Intersection found:\n");
-                        printf("  %c at (%d,%d)\n", typeA, source->row + 1, source->col + 1);
-                        printf("  %c at (%d,%d)\n", typeB, target->row + 1, target->col + 1);
-                        printf("  Distance: %d\n\n", dist);
+                        if (visitor) visitor(source, target, dist, ctx);
+                        count++;
                     }
                 }
                 target = target->next;
@@ -499,6 +1798,70 @@ void find_intersections(Graph* graph, char typeA, char typeB, int maxDistance) {
         }
         source = source->next;
     }
+    INSTR_PHASE_END(PHASE_INTERSECTIONS);
+    return count;
+}
+
+/**
+ * Contexto usado para recolher intersecoes para um array do chamador.
+ */
+typedef struct {
+    Intersection* results;
+    int maxResults;
+    int count;
+} IntersectionCollectContext;
+
+/**
+ * Funcao para guardar uma intersecao no array do chamador.
+ */
+static void collect_intersection(const Vertex* source, const Vertex* target, int distance, void* ctx) {
+    IntersectionCollectContext* collect = (IntersectionCollectContext*)ctx;
+    if (collect->count < collect->maxResults) {
+        collect->results[collect->count].sourceId = source->id;
+        collect->results[collect->count].targetId = target->id;
+        collect->results[collect->count].distance = distance;
+    }
+    collect->count++;
+}
+
+/**
+ * Funcao para recolher as intersecoes entre dois tipos de antenas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param typeA - tipo da antena A
+ * \param typeB - tipo da antena B
+ * \param maxDistance - distancia maxima
+ * \param results - array de saida
+ * \param maxResults - capacidade do array
+ * \return numero total de intersecoes
+ */
+int find_intersections_collect(Graph* graph, char typeA, char typeB, int maxDistance,
+    Intersection* results, int maxResults) {
+    IntersectionCollectContext collect = { results, maxResults, 0 };
+    return find_intersections_visit(graph, typeA, typeB, maxDistance, collect_intersection, &collect);
+}
+
+/**
+ * Funcao para imprimir uma intersecao encontrada.
+ */
+static void print_intersection(const Vertex* source, const Vertex* target, int distance, void* ctx) {
+    (void)ctx;
+    printf("Intersection found:\n");
+    printf("  %c at (%d,%d)\n", source->type, source->row + 1, source->col + 1);
+    printf("  %c at (%d,%d)\n", target->type, target->row + 1, target->col + 1);
+    printf("  Distance: %d\n\n", distance);
+}
+
+/**
+ * Funcao para encontrar interseccoes entre dois tipos de antenas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param typeA - tipo da antena A
+ * \param typeB - tipo da antena B
+ * \param maxDistance - distancia maxima
+ */
+void find_intersections(Graph* graph, char typeA, char typeB, int maxDistance) {
+    find_intersections_visit(graph, typeA, typeB, maxDistance, print_intersection, NULL);
 }
 
 #pragma endregion
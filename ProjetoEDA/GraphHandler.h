@@ -10,6 +10,13 @@
 #define GRAPH_HANDLER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+
+/** Distncia de Manhattan mxima entre antenas do mesmo tipo ligadas por uma aresta. */
+#define GRAPH_RADIUS 4
+
+/** Nmero mximo de vrtices para contar caminhos por programao dinmica (k * 2^(k-1) contadores). */
+#define PATH_DP_MAX_VERTICES 16
 
 #pragma region Structs
 
@@ -35,14 +42,36 @@ typedef struct Edge {
     struct Edge* next;    /**< Prxima aresta na lista de adjacncia */
 } Edge;
 
+/**
+ * @struct CoordIndex
+ * @brief ndice coordenadas -> ID do vrtice.
+ *
+ * Usa uma tabela densa rows x cols quando a matriz est suficientemente preenchida;
+ * em mapas esparsos usa uma tabela de disperso com endereamento aberto.
+ */
+typedef struct CoordIndex {
+    int rows, cols;       /**< Dimenses da matriz indexada */
+    int* cells;           /**< Tabela densa rows x cols (-1 se vazio), ou NULL */
+    long long* keys;      /**< Chaves da tabela de disperso (coordenadas codificadas) */
+    int* ids;             /**< IDs associados a cada chave da tabela de disperso */
+    int capacity;         /**< Capacidade da tabela de disperso (potncia de 2) */
+} CoordIndex;
+
 /**
  * @struct Graph
  * @brief Estrutura que representa o grafo completo de antenas.
  */
 typedef struct Graph {
-    int numVertices;      /**< Nmero total de vrtices no grafo */
-    Vertex* vertices;     /**< Lista ligada de vrtices (antenas) */
+    int numVertices;      /**< Nmero de IDs atribudos (inclui IDs vazios de antenas removidas) */
+    Vertex* vertices;     /**< Lista ligada de vrtices (antenas), por ordem de linha e coluna */
+    Vertex* tail;         /**< ltimo vrtice da lista */
+    Vertex** rowTail;     /**< ltimo vrtice de cada linha (NULL se a linha no tem antenas) */
+    int rowCapacity;      /**< Posies alocadas em rowTail */
+    int capacity;         /**< Posies alocadas em adjList, byId e expanded */
     Edge** adjList;       /**< Vetor de listas de adjacncia para cada vrtice */
+    Vertex** byId;        /**< Vetor ID -> vrtice */
+    CoordIndex index;     /**< ndice coordenadas -> ID */
+    bool* expanded;       /**< Vrtices com adjacncias j criadas (grafo lazy), ou NULL */
 } Graph;
 
 /**
@@ -63,6 +92,61 @@ typedef struct {
     QueueNode* rear;      /**< Final da fila */
 } Queue;
 
+/**
+ * @struct Intersection
+ * @brief Estrutura que representa uma interseo entre duas antenas.
+ */
+typedef struct Intersection {
+    int sourceId;         /**< ID da antena do primeiro tipo */
+    int targetId;         /**< ID da antena do segundo tipo */
+    int distance;         /**< Distncia de Manhattan entre as duas */
+} Intersection;
+
+/**
+ * @struct PathStats
+ * @brief Estatsticas dos caminhos simples entre duas antenas, sem os enumerar na sada.
+ */
+typedef struct PathStats {
+    long long count;      /**< Nmero de caminhos simples com no mximo maxHops saltos */
+    int shortest;         /**< Saltos do caminho mais curto (-1 se no houver caminhos) */
+    int longest;          /**< Saltos do caminho mais longo (-1 se no houver caminhos) */
+} PathStats;
+
+/**
+ * @struct TraversalScratch
+ * @brief Buffers de trabalho reutilizados por vrias travessias sobre o mesmo grafo.
+ *
+ * Um vrtice est visitado quando mark[id] == epoch; cada travessia incrementa epoch,
+ * por isso comear uma nova travessia no exige limpar os vetores. Cada thread deve
+ * usar o seu prprio TraversalScratch.
+ */
+typedef struct TraversalScratch {
+    int capacity;         /**< Nmero de vrtices suportados */
+    unsigned int epoch;   /**< Marca da travessia atual (nunca 0) */
+    unsigned int* mark;   /**< Marca de visita de cada vrtice */
+    int* dist;            /**< Distncia em saltos (BFS) */
+    int* queue;           /**< Fila da BFS */
+    int* path;            /**< Caminho atual (busca de caminhos) */
+    long long* ways;      /**< Tabela da contagem de caminhos por programao dinmica (criada quando  precisa) */
+    size_t waysCapacity;  /**< Nmero de contadores alocados em ways */
+} TraversalScratch;
+
+/**
+ * @brief Funo chamada para cada antena alcanada numa travessia.
+ * O parmetro depth  a profundidade (DFS) ou a distncia em saltos (BFS).
+ */
+typedef void (*VertexVisitor)(const Vertex* vertex, int depth, void* ctx);
+
+/**
+ * @brief Funo chamada para cada caminho encontrado (sequncia de IDs).
+ */
+typedef void (*PathVisitor)(const struct Graph* graph, const int* path, int pathLen, void* ctx);
+
+/**
+ * @brief Funo chamada para cada interseo encontrada.
+ */
+typedef void (*IntersectionVisitor)(const Vertex* source, const Vertex* target, int distance, void* ctx);
+
 #pragma endregion
 
 #pragma region Funes
@@ -72,9 +156,47 @@ typedef struct {
 Graph* read_graph_from_file(const char* filename, int* rows, int* cols);
 
 /**
- * @brief Imprime o grafo na consola (para depurao).
+ * @brief L um ficheiro sem criar arestas: as adjacncias de cada antena so criadas e
+ * guardadas na primeira vez que uma travessia a expande (get_neighbours).
+ * O custo de uma consulta isolada fica proporcional  componente alcanada.
+ */
+Graph* read_graph_lazy(const char* filename, int* rows, int* cols);
+
+/**
+ * @brief Obtm a lista de adjacncia de um vrtice, criando-a se o grafo for lazy.
+ * A criao altera o grafo, por isso um grafo lazy no pode ser consultado por vrias
+ * threads ao mesmo tempo sem chamar expand_graph antes.
+ */
+Edge* get_neighbours(Graph* graph, int id);
+
+/**
+ * @brief Cria as adjacncias que faltam num grafo lazy.
+ */
+void expand_graph(Graph* graph);
+
+/**
+ * @brief Acrescenta uma antena em (row, col) (base 0) com um ID novo e as suas arestas.
+ * A antena entra na lista de vrtices pela ordem de linha e coluna e nas listas dos vizinhos
+ * pela mesma ordem de read_graph_from_file, por isso as travessias visitam as antenas pela
+ * mesma ordem que num grafo lido do ficheiro. Os IDs das outras antenas no mudam.
+ * O custo  proporcional s arestas criadas, s antenas da linha e s linhas vazias
+ * anteriores, e no ao tamanho do grafo.
+ * Os TraversalScratch criados antes deixam de ser aceites e tm de ser recriados.
+ * @return ID da antena ou -1 se a posio estiver ocupada ou faltar memria (o grafo fica como estava).
+ */
+int graph_insert_antenna(Graph* graph, int row, int col, char type);
+
+/**
+ * @brief Remove a antena em (row, col) (base 0) com as suas arestas. O ID fica vazio e
+ * no volta a ser atribudo; os IDs e os ponteiros Vertex das outras antenas continuam vlidos.
+ * @return ID da antena removida ou -1 se no existir.
+ */
+int graph_delete_antenna(Graph* graph, int row, int col);
+
+/**
+ * @brief Imprime o grafo na consola (para depurao). Num grafo lazy cria as adjacncias que faltam.
  */
-void print_graph(const Graph* graph);
+void print_graph(Graph* graph);
 
 /**
  * @brief Liberta toda a memria alocada para o grafo.
@@ -101,6 +223,143 @@ void find_all_paths(Graph* graph, int start_row, int start_col, int end_row, int
  */
 void find_intersections(Graph* graph, char typeA, char typeB, int maxDistance);
 
+/**
+ * @brief Imprime o nmero de caminhos entre duas antenas e o comprimento do mais curto e do mais longo.
+ */
+void print_path_stats(Graph* graph, int start_row, int start_col, int end_row, int end_col, int maxHops);
+
+#pragma endregion
+
+#pragma region Consultas
+/**
+ * @brief Calcula a distncia de Manhattan entre (x1, y1) e (x2, y2), a mtrica das arestas do grafo.
+ */
+int manhattan_distance(int x1, int y1, int x2, int y2);
+
+/**
+ * @brief Procura o ID do vrtice nas coordenadas indicadas (base 0).
+ * @return ID do vrtice ou -1 se no existir antena nessa posio.
+ */
+int find_vertex_id(Graph* graph, int row, int col);
+
+/**
+ * @brief Obtm o vrtice com o ID indicado em O(1).
+ * @return Ponteiro para o vrtice ou NULL se o ID for invlido.
+ */
+Vertex* get_vertex(const Graph* graph, int id);
+
+/**
+ * @brief Executa uma DFS a partir da antena em (start_row, start_col) e chama o visitor
+ * para cada antena alcanada, incluindo a inicial (profundidade 0).
+ * @return Nmero de antenas visitadas ou -1 se no existir antena no incio.
+ */
+int dfs_visit(Graph* graph, int start_row, int start_col, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief Executa uma BFS a partir da antena em (start_row, start_col) e chama o visitor
+ * para cada antena alcanada com a respetiva distncia em saltos.
+ * @return Nmero de antenas visitadas ou -1 se no existir antena no incio.
+ */
+int bfs_visit(Graph* graph, int start_row, int start_col, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief Preenche ids com os IDs das antenas pela ordem da DFS (no mximo maxIds).
+ * @return Nmero total de antenas visitadas ou -1 se no existir antena no incio.
+ */
+int dfs_collect(Graph* graph, int start_row, int start_col, int* ids, int maxIds);
+
+/**
+ * @brief Preenche ids (e dists, se no for NULL) pela ordem da BFS (no mximo maxIds).
+ * @return Nmero total de antenas visitadas ou -1 se no existir antena no incio.
+ */
+int bfs_collect(Graph* graph, int start_row, int start_col, int* ids, int* dists, int maxIds);
+
+/**
+ * @brief BFS com vrias origens em simultneo, numa nica passagem O(V + E).
+ *
+ * No fim, dist[id]  a distncia em saltos at  origem mais prxima (-1 se nenhuma
+ * origem alcana o vrtice) e nearest[id]  o ID dessa origem (-1 se inalcanvel).
+ * Em caso de empate fica a origem que aparece primeiro em sourceIds.
+ * Ambos os vetores tm numVertices posies; nearest pode ser NULL.
+ * @return Nmero de antenas alcanadas ou -1 se algum ID de origem for invlido.
+ */
+int multi_source_bfs(Graph* graph, const int* sourceIds, int numSources, int* dist, int* nearest);
+
+/**
+ * @brief Enumera todos os caminhos simples entre duas antenas e entrega cada um ao visitor.
+ * @return Nmero de caminhos encontrados ou -1 se alguma das antenas no existir.
+ */
+int find_all_paths_visit(Graph* graph, int start_row, int start_col, int end_row, int end_col,
+    PathVisitor visitor, void* ctx);
+
+/**
+ * @brief Entrega ao visitor cada par (typeA, typeB) a uma distncia no superior a maxDistance.
+ * @return Nmero de intersees encontradas.
+ */
+int find_intersections_visit(Graph* graph, char typeA, char typeB, int maxDistance,
+    IntersectionVisitor visitor, void* ctx);
+
+/**
+ * @brief Preenche results com as intersees encontradas (no mximo maxResults).
+ * @return Nmero total de intersees, que pode exceder maxResults.
+ */
+int find_intersections_collect(Graph* graph, char typeA, char typeB, int maxDistance,
+    Intersection* results, int maxResults);
+
+/**
+ * @brief Conta os caminhos simples entre duas antenas com no mximo maxHops saltos
+ * (maxHops < 0 sem limite) e calcula o mais curto e o mais longo, sem imprimir caminhos.
+ *
+ * S so considerados os vrtices que podem estar num caminho dentro do limite. Se forem
+ * no mximo PATH_DP_MAX_VERTICES, a contagem  feita por programao dinmica sobre
+ * subconjuntos (bitmask); caso contrrio, por enumerao podada pela distncia ao destino.
+ * O trabalho fica limitado  componente da origem.
+ * @return 0 ou -1 se alguma das antenas no existir ou faltar memria.
+ */
+int find_path_stats(Graph* graph, int start_row, int start_col, int end_row, int end_col, int maxHops,
+    PathStats* stats);
+
+#pragma endregion
+
+#pragma region Travessias com buffers partilhados
+/**
+ * @brief Cria os buffers de trabalho para travessias sobre o grafo.
+ * @return Buffers criados ou NULL se faltar memria.
+ */
+TraversalScratch* create_scratch(const Graph* graph);
+
+/**
+ * @brief Liberta os buffers de trabalho.
+ */
+void free_scratch(TraversalScratch* scratch);
+
+/**
+ * @brief DFS a partir do vrtice startId usando os buffers indicados (sem alocaes).
+ * @return Nmero de antenas visitadas ou -1 se o ID for invlido.
+ */
+int dfs_visit_scratch(Graph* graph, TraversalScratch* scratch, int startId, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief BFS a partir do vrtice startId usando os buffers indicados (sem alocaes).
+ * @return Nmero de antenas visitadas ou -1 se o ID for invlido.
+ */
+int bfs_visit_scratch(Graph* graph, TraversalScratch* scratch, int startId, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief Enumera os caminhos simples entre startId e endId usando os buffers indicados.
+ * @return Nmero de caminhos encontrados ou -1 se algum ID for invlido.
+ */
+int find_all_paths_scratch(Graph* graph, TraversalScratch* scratch, int startId, int endId,
+    PathVisitor visitor, void* ctx);
+
+/**
+ * @brief find_path_stats entre os vrtices startId e endId usando os buffers indicados
+ * (marcas, distncias, fila e tabela da programao dinmica), sem alocaes por consulta.
+ * @return 0 ou -1 se algum ID for invlido.
+ */
+int find_path_stats_scratch(Graph* graph, TraversalScratch* scratch, int startId, int endId, int maxHops,
+    PathStats* stats);
+
 #pragma endregion
 
 #endif
@@ -0,0 +1,168 @@
+/**
+ * @file Instrumentation.c
+ * @brief Implementacao dos contadores e tempos por fase.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "Instrumentation.h"
+#include "ThreadHandler.h"
+
+#pragma region Estado
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+/* Os tempos sao guardados em nanossegundos para poderem ser somados de forma atomica. */
+static volatile long long counters[INSTR_NUM_COUNTERS];
+static volatile long long phaseCalls[INSTR_NUM_PHASES];
+static volatile long long phaseNanos[INSTR_NUM_PHASES];
+
+/* Contagens de cada thread ainda por somar aos totais globais (ver instr_flush). */
+static THREAD_LOCAL long long localCounters[INSTR_NUM_COUNTERS];
+
+static const char* COUNTER_NAMES[INSTR_NUM_COUNTERS] = {
+    "allocations", "edges_examined", "vertices_visited", "paths_emitted"
+};
+
+static const char* PHASE_NAMES[INSTR_NUM_PHASES] = {
+    "parse", "nefasto", "edges", "traversal", "paths", "intersections"
+};
+
+#pragma endregion
+
+#pragma region Funcoes
+
+/**
+ * Funcao para indicar se a instrumentacao foi compilada.
+ *
+ * \return true se EDA_INSTRUMENTATION esta definido
+ */
+bool instr_enabled(void) {
+#ifdef EDA_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Funcao para obter o tempo monotonico atual em segundos.
+ *
+ * \return segundos desde uma origem arbitraria
+ */
+double instr_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * Funcao para somar um valor a um contador.
+ * So altera a copia da thread atual, sem operacoes atomicas nem partilha de linhas de cache.
+ *
+ * \param counter - contador
+ * \param n - valor a somar
+ */
+void instr_add(InstrCounter counter, long long n) {
+    localCounters[counter] += n;
+}
+
+/**
+ * Funcao para somar os contadores locais da thread atual aos totais globais.
+ */
+void instr_flush(void) {
+    for (int i = 0; i < INSTR_NUM_COUNTERS; i++) {
+        if (localCounters[i] == 0) continue;
+        thread_atomic_add64(&counters[i], localCounters[i]);
+        localCounters[i] = 0;
+    }
+}
+
+/**
+ * Funcao para registar uma execucao de uma fase.
+ *
+ * \param phase - fase
+ * \param seconds - duracao em segundos
+ */
+void instr_phase_add(InstrPhase phase, double seconds) {
+    instr_flush();
+    thread_atomic_add64(&phaseCalls[phase], 1);
+    thread_atomic_add64(&phaseNanos[phase], (long long)(seconds * 1e9));
+}
+
+/**
+ * Funcao para obter o valor de um contador.
+ * Os valores locais das outras threads so contam depois da sua fase acabar ou de terminarem.
+ *
+ * \param counter - contador
+ * \return valor atual
+ */
+long long instr_get_counter(InstrCounter counter) {
+    instr_flush();
+    return thread_atomic_load64(&counters[counter]);
+}
+
+/**
+ * Funcao para obter o tempo acumulado de uma fase.
+ *
+ * \param phase - fase
+ * \return segundos acumulados
+ */
+double instr_get_phase_seconds(InstrPhase phase) {
+    return (double)thread_atomic_load64(&phaseNanos[phase]) * 1e-9;
+}
+
+/**
+ * Funcao para colocar contadores e tempos a zero.
+ */
+void instr_reset(void) {
+    for (int i = 0; i < INSTR_NUM_COUNTERS; i++) {
+        localCounters[i] = 0;
+        thread_atomic_store64(&counters[i], 0);
+    }
+    for (int i = 0; i < INSTR_NUM_PHASES; i++) {
+        thread_atomic_store64(&phaseCalls[i], 0);
+        thread_atomic_store64(&phaseNanos[i], 0);
+    }
+}
+
+/**
+ * Funcao para escrever o relatorio em JSON.
+ *
+ * \param out - ficheiro de saida
+ */
+void instr_report(FILE* out) {
+    fprintf(out, "{\n  \"enabled\": %s,\n  \"counters\": {", instr_enabled() ? "true" : "false");
+    for (int i = 0; i < INSTR_NUM_COUNTERS; i++)
+        fprintf(out, "%s\n    \"%s\": %lld", i ? "," : "", COUNTER_NAMES[i],
+            instr_get_counter((InstrCounter)i));
+    fprintf(out, "\n  },\n  \"phases\": {");
+    for (int i = 0; i < INSTR_NUM_PHASES; i++)
+        fprintf(out, "%s\n    \"%s\": { \"calls\": %lld, \"seconds\": %.9f }", i ? "," : "",
+            PHASE_NAMES[i], thread_atomic_load64(&phaseCalls[i]), instr_get_phase_seconds((InstrPhase)i));
+    fprintf(out, "\n  }\n}\n");
+}
+
+#pragma endregion
@@ -0,0 +1,119 @@
+/**
+ * @file Instrumentation.h
+ * @brief Contadores e tempos por fase para diagnostico de desempenho.
+ *
+ * As macros INSTR_* so fazem algo quando o projeto e compilado com
+ * EDA_INSTRUMENTATION definido (/D EDA_INSTRUMENTATION ou -DEDA_INSTRUMENTATION);
+ * caso contrario nao geram codigo. As funcoes instr_* existem sempre, para que
+ * o relatorio possa ser pedido em qualquer build (indica "enabled": false).
+ *
+ * Cada thread acumula os contadores em copias locais, que so sao somadas aos totais
+ * globais (com somas atomicas) no fim de cada fase, quando a thread termina ou quando
+ * os valores sao lidos; o tempo de uma fase soma as duracoes medidas em todas as threads.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#pragma region Enums
+
+/**
+ * @enum InstrCounter
+ * @brief Contadores de eventos nos caminhos criticos.
+ */
+typedef enum InstrCounter {
+    INSTR_ALLOCATIONS,        /**< Blocos alocados (nos, vertices, arestas, filas, ...) */
+    INSTR_EDGES_EXAMINED,     /**< Pares/arestas analisados na construcao, travessias e intersecoes */
+    INSTR_VERTICES_VISITED,   /**< Vertices visitados pelas travessias */
+    INSTR_PATHS_EMITTED,      /**< Caminhos completos encontrados */
+    INSTR_NUM_COUNTERS
+} InstrCounter;
+
+/**
+ * @enum InstrPhase
+ * @brief Fases com tempo medido.
+ */
+typedef enum InstrPhase {
+    PHASE_PARSE,              /**< Leitura de ficheiros de mapa */
+    PHASE_NEFASTO,            /**< Detecao de antenas nefastas */
+    PHASE_EDGES,              /**< Construcao das arestas do grafo */
+    PHASE_TRAVERSAL,          /**< DFS/BFS */
+    PHASE_PATHS,              /**< Enumeracao de caminhos */
+    PHASE_INTERSECTIONS,      /**< Procura de intersecoes */
+    INSTR_NUM_PHASES
+} InstrPhase;
+
+#pragma endregion
+
+#pragma region Macros
+
+#ifdef EDA_INSTRUMENTATION
+#define INSTR_COUNT(counter, n) instr_add((counter), (long long)(n))
+#define INSTR_PHASE_BEGIN(phase) double instr_start_##phase = instr_now()
+#define INSTR_PHASE_END(phase) instr_phase_add((phase), instr_now() - instr_start_##phase)
+#define INSTR_FLUSH() instr_flush()
+#else
+#define INSTR_COUNT(counter, n) ((void)0)
+#define INSTR_PHASE_BEGIN(phase) ((void)0)
+#define INSTR_PHASE_END(phase) ((void)0)
+#define INSTR_FLUSH() ((void)0)
+#endif
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Indica se a instrumentacao foi compilada.
+ */
+bool instr_enabled(void);
+
+/**
+ * @brief Obtem o tempo monotonico atual em segundos (origem arbitraria).
+ */
+double instr_now(void);
+
+/**
+ * @brief Soma n a copia local (da thread atual) do contador indicado.
+ */
+void instr_add(InstrCounter counter, long long n);
+
+/**
+ * @brief Soma os contadores locais da thread atual aos totais globais e coloca-os a zero.
+ */
+void instr_flush(void);
+
+/**
+ * @brief Regista uma execucao da fase com a duracao indicada (e faz instr_flush).
+ */
+void instr_phase_add(InstrPhase phase, double seconds);
+
+/**
+ * @brief Obtem o valor atual de um contador (inclui os valores locais da thread atual).
+ */
+long long instr_get_counter(InstrCounter counter);
+
+/**
+ * @brief Obtem o tempo acumulado de uma fase em segundos.
+ */
+double instr_get_phase_seconds(InstrPhase phase);
+
+/**
+ * @brief Coloca todos os contadores e tempos a zero (globais e locais da thread atual).
+ */
+void instr_reset(void);
+
+/**
+ * @brief Escreve um relatorio em JSON com os contadores e os tempos por fase.
+ * @param out Ficheiro de saida (ex: stdout ou stderr).
+ */
+void instr_report(FILE* out);
+
+#pragma endregion
+
+#endif
@@ -9,6 +9,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "ListHandler.h"
+#include "Instrumentation.h"
 
 #pragma region Libertao de memmoria
 /**
@@ -31,11 +32,11 @@ void deallocate(Node** root) {
  */
 void insert_antenna(Node** root, int x, int y, char type) {
     Node* new_node = malloc(sizeof(Node));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
     new_node->next = NULL;
     new_node->x = x;
     new_node->y = y;
     new_node->type = type;
-    new_node->resonance = get_frequence(type);
 
     if (*root == NULL) {
         *root = new_node;
@@ -77,6 +78,14 @@ void delete_antenna(Node** root, int x, int y) {
     printf("Antena removida de (%d, %d).\n", x, y);
 }
 
+/**
+ * @brief Imprime uma antena e as suas coordenadas.
+ */
+static void print_antenna(const Node* antenna, void* ctx) {
+    (void)ctx;
+    printf("Antena %c em (%d, %d)\n", antenna->type, antenna->x + 1, antenna->y + 1);
+}
+
 /**
  * Imprime as antenas e as suas coordenadas existentes.
  *
@@ -84,10 +93,50 @@ void delete_antenna(Node** root, int x, int y) {
  */
 void print_antennas(Node* root) {
     printf("\nAntenas existentes:\n");
+    visit_antennas(root, print_antenna, NULL);
+}
+
+/**
+ * @brief Chama o visitor para cada antena existente (ignora as nefastas).
+ */
+int visit_antennas(Node* root, AntennaVisitor visitor, void* ctx) {
+    int count = 0;
     for (Node* curr = root; curr != NULL; curr = curr->next) {
-		if (curr->type == '#') continue;
-        printf("Antena %c em (%d, %d)\n", curr->type, curr->x + 1, curr->y + 1);
+        if (curr->type == '#') continue;
+        if (visitor) visitor(curr, ctx);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Contexto usado para copiar antenas para um array do chamador.
+ */
+typedef struct {
+    AntennaInfo* antennas;
+    int maxAntennas;
+    int count;
+} AntennaCollectContext;
+
+/**
+ * @brief Copia uma antena para o array do chamador.
+ */
+static void collect_antenna(const Node* antenna, void* ctx) {
+    AntennaCollectContext* collect = (AntennaCollectContext*)ctx;
+    if (collect->count < collect->maxAntennas) {
+        collect->antennas[collect->count].x = antenna->x;
+        collect->antennas[collect->count].y = antenna->y;
+        collect->antennas[collect->count].type = antenna->type;
     }
+    collect->count++;
+}
+
+/**
+ * @brief Copia as antenas existentes para um array (no mximo maxAntennas).
+ */
+int collect_antennas(Node* root, AntennaInfo* antennas, int maxAntennas) {
+    AntennaCollectContext collect = { antennas, maxAntennas, 0 };
+    return visit_antennas(root, collect_antenna, &collect);
 }
 
 
@@ -129,6 +178,7 @@ void remove_nefasto(Node** root) {
 void detect_nefasto(Node** root) {
     Node* curr = *root;
     Node* temp_list = NULL;
+    INSTR_PHASE_BEGIN(PHASE_NEFASTO);
     remove_nefasto(root);
 
     for (Node* curr = *root; curr != NULL; curr = curr->next) {
@@ -161,6 +211,7 @@ void detect_nefasto(Node** root) {
             temp_curr = temp_curr->next;
         }
     }
+    INSTR_PHASE_END(PHASE_NEFASTO);
 }
 #pragma endregion
 
@@ -175,19 +226,30 @@ void read_matrix_from_file(const char* filename, Node** root, int* rows, int* co
         return;
     }
 
+    INSTR_PHASE_BEGIN(PHASE_PARSE);
     char line[100];
+    int y = 0;
     *rows = 0;
     *cols = 0;
 
+    // Linhas maiores que o buffer chegam em vrios pedaos: s se avana de linha ao ler '\n'
     while (fgets(line, sizeof(line), file)) {
-        int x = 0;
-        for (x = 0; line[x] != '\n' && line[x] != '\0'; x++) {
-            if (line[x] != '.') insert_antenna(root, *rows, x, line[x]);
+        int i;
+        for (i = 0; line[i] != '\n' && line[i] != '\0'; i++, y++) {
+            if (line[i] != '.') insert_antenna(root, *rows, y, line[i]);
         }
-        if (x > *cols) *cols = x;
+        if (line[i] == '\n') {
+            if (y > *cols) *cols = y;
+            (*rows)++;
+            y = 0;
+        }
+    }
+    if (y > 0) {
+        if (y > *cols) *cols = y;
         (*rows)++;
     }
     fclose(file);
+    INSTR_PHASE_END(PHASE_PARSE);
 }
 
 /**
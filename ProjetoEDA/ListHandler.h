@@ -24,11 +24,24 @@
   */
 typedef struct Node {
     int x, y;        /**< Coordenadas da antena */
-    char type;       /**< Tipo da antena */
-    double resonance;/**< Frequncia de ressonncia */
+    char type;       /**< Tipo da antena (a frequncia obtm-se com get_frequence) */
     struct Node* next; /**< Ponteiro para o prximo n */
 } Node;
 
+/**
+ * @struct AntennaInfo
+ * @brief Cpia das coordenadas e do tipo de uma antena, usada para devolver resultados.
+ */
+typedef struct AntennaInfo {
+    int x, y;        /**< Coordenadas da antena */
+    char type;       /**< Tipo da antena */
+} AntennaInfo;
+
+/**
+ * @brief Funo chamada para cada antena visitada.
+ */
+typedef void (*AntennaVisitor)(const Node* antenna, void* ctx);
+
 // Structure to represent a node in the adjacency list
 struct NodeAdj {
     int vertex;
@@ -104,6 +117,24 @@ void print_matrix(Node* root, int rows, int cols);
  * @param root Ponteiro para a raiz da lista.
  */
 void print_antennas(Node* root);
+
+/**
+ * @brief Chama o visitor para cada antena existente (ignora as nefastas).
+ * @param root Ponteiro para a raiz da lista.
+ * @param visitor Funo chamada para cada antena.
+ * @param ctx Contexto passado ao visitor.
+ * @return Nmero de antenas visitadas.
+ */
+int visit_antennas(Node* root, AntennaVisitor visitor, void* ctx);
+
+/**
+ * @brief Copia as antenas existentes para um array (no mximo maxAntennas).
+ * @param root Ponteiro para a raiz da lista.
+ * @param antennas Array de sada.
+ * @param maxAntennas Capacidade do array.
+ * @return Nmero total de antenas, que pode exceder maxAntennas.
+ */
+int collect_antennas(Node* root, AntennaInfo* antennas, int maxAntennas);
 #pragma endregion
 
 
@@ -0,0 +1,156 @@
+/**
+ * @file MapGenerator.c
+ * @brief Implementacao do gerador de mapas sinteticos de antenas.
+ *
+ * O gerador usa um xorshift proprio para que a mesma semente produza o mesmo
+ * mapa em qualquer plataforma (rand() nao e portavel entre bibliotecas).
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MapGenerator.h"
+
+#pragma region Gerador aleatorio
+
+static const char MAPGEN_TYPES[MAPGEN_MAX_TYPES + 1] = "A0BCDEFGHIJKLMNOPQRSTUVWXYZ12345678";
+
+/**
+ * Funcao para obter o proximo valor do gerador xorshift32.
+ *
+ * \param state - estado do gerador
+ * \return valor pseudo-aleatorio
+ */
+static unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * Funcao para obter um valor pseudo-aleatorio uniforme em [0, 1).
+ *
+ * \param state - estado do gerador
+ * \return valor em [0, 1)
+ */
+static double next_unit(unsigned int* state) {
+    return (next_random(state) >> 8) * (1.0 / 16777216.0);
+}
+
+#pragma endregion
+
+#pragma region Geracao de mapas
+
+/**
+ * Funcao para preencher as opcoes por omissao.
+ *
+ * \param options - opcoes a preencher
+ */
+void mapgen_default_options(MapGenOptions* options) {
+    options->rows = 50;
+    options->cols = 50;
+    options->density = 0.05;
+    options->numTypes = 2;
+    options->clustering = 0.0;
+    options->seed = 1;
+}
+
+/**
+ * Funcao para procurar uma antena ja gerada perto de uma celula (acima ou a esquerda).
+ *
+ * \param map - texto do mapa em construcao
+ * \param stride - comprimento de cada linha incluindo '\n'
+ * \param row - linha da celula
+ * \param col - coluna da celula
+ * \param state - estado do gerador
+ * \return tipo da antena vizinha ou '.' se nao existir
+ */
+static char nearby_antenna(const char* map, int stride, int row, int col, unsigned int* state) {
+    static const int offsets[][2] = { {0, -1}, {-1, 0}, {-1, -1}, {-1, 1}, {0, -2}, {-2, 0} };
+    int count = (int)(sizeof(offsets) / sizeof(offsets[0]));
+    int first = (int)(next_random(state) % (unsigned int)count);
+
+    for (int i = 0; i < count; i++) {
+        int r = row + offsets[(first + i) % count][0];
+        int c = col + offsets[(first + i) % count][1];
+        if (r < 0 || c < 0 || c >= stride - 1) continue;
+        char cell = map[r * stride + c];
+        if (cell != '.') return cell;
+    }
+    return '.';
+}
+
+/**
+ * Funcao para gerar um mapa sintetico.
+ * Com clustering > 0, celulas junto de antenas ja geradas tem maior probabilidade
+ * de receber uma antena e tendem a herdar o tipo da vizinha.
+ *
+ * \param options - parametros de geracao
+ * \return texto do mapa ou NULL
+ */
+char* generate_map(const MapGenOptions* options) {
+    if (options->rows <= 0 || options->cols <= 0) return NULL;
+
+    int numTypes = options->numTypes;
+    if (numTypes < 1) numTypes = 1;
+    if (numTypes > MAPGEN_MAX_TYPES) numTypes = MAPGEN_MAX_TYPES;
+
+    int stride = options->cols + 1;
+    char* map = (char*)malloc((size_t)options->rows * stride + 1);
+    if (!map) return NULL;
+
+    unsigned int state = options->seed ? options->seed : 0x9E3779B9u;
+
+    for (int row = 0; row < options->rows; row++) {
+        for (int col = 0; col < options->cols; col++) {
+            char cell = '.';
+            char neighbour = options->clustering > 0.0 ? nearby_antenna(map, stride, row, col, &state) : '.';
+            double p = options->density;
+            if (neighbour != '.') p += options->clustering * (1.0 - options->density) * 0.5;
+
+            if (next_unit(&state) < p) {
+                if (neighbour != '.' && next_unit(&state) < options->clustering)
+                    cell = neighbour;
+                else
+                    cell = MAPGEN_TYPES[next_random(&state) % (unsigned int)numTypes];
+            }
+            map[row * stride + col] = cell;
+        }
+        map[row * stride + options->cols] = '\n';
+    }
+    map[(size_t)options->rows * stride] = '\0';
+    return map;
+}
+
+/**
+ * Funcao para gerar um mapa e escreve-lo num ficheiro.
+ *
+ * \param filename - nome do ficheiro
+ * \param options - parametros de geracao
+ * \return true se o ficheiro foi escrito
+ */
+bool write_generated_map(const char* filename, const MapGenOptions* options) {
+    char* map = generate_map(options);
+    if (!map) return false;
+
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        printf("Erro ao abrir ficheiro: %s\n", filename);
+        free(map);
+        return false;
+    }
+    fputs(map, file);
+    fclose(file);
+    free(map);
+    return true;
+}
+
+#pragma endregion
@@ -0,0 +1,53 @@
+/**
+ * @file MapGenerator.h
+ * @brief Declaracao do gerador de mapas sinteticos de antenas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef MAP_GENERATOR_H
+#define MAP_GENERATOR_H
+
+#include <stdbool.h>
+
+#pragma region Structs
+
+/** Numero maximo de tipos de antena distintos que o gerador consegue usar. */
+#define MAPGEN_MAX_TYPES 35
+
+/**
+ * @struct MapGenOptions
+ * @brief Parametros de geracao de um mapa sintetico.
+ */
+typedef struct MapGenOptions {
+    int rows, cols;       /**< Dimensoes do mapa */
+    double density;       /**< Probabilidade base de uma celula ter antena (0..1) */
+    int numTypes;         /**< Numero de tipos de antena (1..MAPGEN_MAX_TYPES) */
+    double clustering;    /**< Tendencia para agrupar antenas do mesmo tipo (0..1) */
+    unsigned int seed;    /**< Semente do gerador (mesma semente -> mesmo mapa) */
+} MapGenOptions;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Preenche as opcoes com valores por omissao (50x50, densidade 0.05, 2 tipos).
+ */
+void mapgen_default_options(MapGenOptions* options);
+
+/**
+ * @brief Gera um mapa no formato dos ficheiros Mapa*.txt (linhas terminadas em '\n').
+ * @return Texto do mapa alocado dinamicamente (libertar com free) ou NULL.
+ */
+char* generate_map(const MapGenOptions* options);
+
+/**
+ * @brief Gera um mapa e escreve-o num ficheiro de texto.
+ * @return true se o ficheiro foi escrito.
+ */
+bool write_generated_map(const char* filename, const MapGenOptions* options);
+
+#pragma endregion
+
+#endif
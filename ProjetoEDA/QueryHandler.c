@@ -0,0 +1,373 @@
+/**
+ * @file QueryHandler.c
+ * @brief Implementacao da execucao em lote de consultas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "QueryHandler.h"
+#include "ThreadHandler.h"
+#include "Instrumentation.h"
+
+/** Numero de consultas executadas entre cada escrita dos resultados. */
+#define QUERY_CHUNK 1024
+
+#pragma region Structs
+
+/**
+ * @struct OutputBuffer
+ * @brief Texto produzido por uma consulta, guardado ate poder ser escrito por ordem.
+ */
+typedef struct OutputBuffer {
+    char* data;           /**< Texto (terminado em '\0') */
+    size_t len;           /**< Comprimento do texto */
+    size_t capacity;      /**< Capacidade alocada */
+    bool failed;          /**< true se faltou memoria */
+} OutputBuffer;
+
+/**
+ * @struct BatchContext
+ * @brief Bloco de consultas partilhado pelas threads.
+ */
+typedef struct BatchContext {
+    Graph* graph;             /**< Grafo consultado (so leitura) */
+    const Query* queries;     /**< Consultas do bloco */
+    OutputBuffer* outputs;    /**< Resultado de cada consulta do bloco */
+    int count;                /**< Numero de consultas do bloco */
+    volatile long next;       /**< Proxima consulta por executar */
+} BatchContext;
+
+/**
+ * @struct WorkerContext
+ * @brief Estado de uma thread: o bloco e os seus buffers de travessia.
+ */
+typedef struct WorkerContext {
+    BatchContext* batch;          /**< Bloco atual */
+    TraversalScratch* scratch;    /**< Buffers da thread */
+} WorkerContext;
+
+#pragma endregion
+
+#pragma region Texto dos resultados
+
+/**
+ * Funcao para acrescentar texto formatado a um buffer.
+ *
+ * \param buffer - buffer de saida
+ * \param format - formato (como printf)
+ */
+static void buffer_printf(OutputBuffer* buffer, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (needed < 0 || buffer->failed) return;
+
+    if (buffer->len + needed + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (buffer->len + needed + 1 > capacity) capacity *= 2;
+        char* data = (char*)realloc(buffer->data, capacity);
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!data) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    va_start(args, format);
+    vsnprintf(buffer->data + buffer->len, needed + 1, format, args);
+    va_end(args);
+    buffer->len += needed;
+}
+
+/**
+ * Funcao para escrever uma antena visitada (ignora a antena de partida), como dfs e bfs.
+ */
+static void buffer_visited_antenna(const Vertex* vertex, int depth, void* ctx) {
+    if (depth == 0) return;
+    buffer_printf((OutputBuffer*)ctx, "Antenna at (%d, %d) of type %c\n", vertex->row + 1, vertex->col + 1, vertex->type);
+}
+
+/**
+ * Funcao para escrever um caminho, como find_all_paths.
+ */
+static void buffer_path(const Graph* graph, const int* path, int pathLen, void* ctx) {
+    OutputBuffer* buffer = (OutputBuffer*)ctx;
+    buffer_printf(buffer, "Path: ");
+    for (int i = 0; i < pathLen; i++) {
+        Vertex* vertex = get_vertex(graph, path[i]);
+        if (vertex) buffer_printf(buffer, "(%d,%d)%s", vertex->row + 1, vertex->col + 1, i == pathLen - 1 ? "" : " -> ");
+    }
+    buffer_printf(buffer, "\n");
+}
+
+/**
+ * Funcao para escrever uma intersecao, como find_intersections.
+ */
+static void buffer_intersection(const Vertex* source, const Vertex* target, int distance, void* ctx) {
+    OutputBuffer* buffer = (OutputBuffer*)ctx;
+    buffer_printf(buffer, "Intersection found:\n");
+    buffer_printf(buffer, "  %c at (%d,%d)\n", source->type, source->row + 1, source->col + 1);
+    buffer_printf(buffer, "  %c at (%d,%d)\n", target->type, target->row + 1, target->col + 1);
+    buffer_printf(buffer, "  Distance: %d\n\n", distance);
+}
+
+#pragma endregion
+
+#pragma region Execucao
+
+/**
+ * Funcao para executar uma consulta, escrevendo o resultado num buffer.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param scratch - buffers de travessia da thread
+ * \param query - consulta
+ * \param out - buffer de saida
+ */
+static void run_query(Graph* graph, TraversalScratch* scratch, const Query* query, OutputBuffer* out) {
+    int startId, endId;
+
+    switch (query->kind) {
+    case QUERY_DFS:
+    case QUERY_BFS:
+        startId = find_vertex_id(graph, query->row - 1, query->col - 1);
+        if (startId == -1) {
+            buffer_printf(out, "No antenna found at (%d, %d)\n", query->row, query->col);
+            break;
+        }
+        if (query->kind == QUERY_DFS) {
+            buffer_printf(out, "DFS from antenna at (%d, %d):\n", query->row, query->col);
+            dfs_visit_scratch(graph, scratch, startId, buffer_visited_antenna, out);
+        }
+        else {
+            buffer_printf(out, "BFS from antenna at (%d, %d):\n", query->row, query->col);
+            bfs_visit_scratch(graph, scratch, startId, buffer_visited_antenna, out);
+        }
+        break;
+
+    case QUERY_PATHS:
+        startId = find_vertex_id(graph, query->row - 1, query->col - 1);
+        endId = find_vertex_id(graph, query->endRow - 1, query->endCol - 1);
+        if (startId == -1 || endId == -1) {
+            buffer_printf(out, "One or both antennas not found.\n");
+            break;
+        }
+        buffer_printf(out, "All paths from (%d,%d) to (%d,%d):\n", query->row, query->col, query->endRow, query->endCol);
+        find_all_paths_scratch(graph, scratch, startId, endId, buffer_path, out);
+        break;
+
+    case QUERY_PATH_STATS: {
+        PathStats stats;
+        startId = find_vertex_id(graph, query->row - 1, query->col - 1);
+        endId = find_vertex_id(graph, query->endRow - 1, query->endCol - 1);
+        if (startId == -1 || endId == -1
+            || find_path_stats_scratch(graph, scratch, startId, endId, query->maxHops, &stats) == -1) {
+            buffer_printf(out, "One or both antennas not found.\n");
+            break;
+        }
+        buffer_printf(out, "Path statistics from (%d,%d) to (%d,%d):\n", query->row, query->col, query->endRow, query->endCol);
+        buffer_printf(out, "  Paths: %lld\n", stats.count);
+        buffer_printf(out, "  Shortest: %d\n", stats.shortest);
+        buffer_printf(out, "  Longest: %d\n", stats.longest);
+        break;
+    }
+
+    case QUERY_INTERSECTIONS:
+        find_intersections_visit(graph, query->typeA, query->typeB, query->maxDistance, buffer_intersection, out);
+        break;
+    }
+}
+
+/**
+ * Funcao executada por cada thread: retira consultas do bloco ate nao restar nenhuma.
+ *
+ * \param arg - contexto da thread (WorkerContext)
+ */
+static void query_worker(void* arg) {
+    WorkerContext* worker = (WorkerContext*)arg;
+    BatchContext* batch = worker->batch;
+
+    for (;;) {
+        long i = thread_atomic_add(&batch->next, 1);
+        if (i >= batch->count) break;
+        run_query(batch->graph, worker->scratch, &batch->queries[i], &batch->outputs[i]);
+    }
+}
+
+/**
+ * Funcao para executar consultas e escrever os resultados pela ordem dada.
+ * As consultas sao executadas em blocos de QUERY_CHUNK; os resultados de cada bloco
+ * sao escritos quando o bloco termina, o que limita a memoria usada pelos textos.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param queries - consultas
+ * \param count - numero de consultas
+ * \param numThreads - numero de threads (0 = numero de processadores)
+ * \param out - ficheiro de saida
+ * \return numero de consultas executadas ou -1
+ */
+int run_queries(Graph* graph, const Query* queries, int count, int numThreads, FILE* out) {
+    if (count <= 0) return 0;
+    if (numThreads <= 0) numThreads = thread_hardware_count();
+    if (numThreads > count) numThreads = count;
+    // Num grafo lazy as listas sao criadas durante as travessias: com varias threads criam-se antes
+    if (numThreads > 1) expand_graph(graph);
+
+    int chunk = count < QUERY_CHUNK ? count : QUERY_CHUNK;
+    OutputBuffer* outputs = (OutputBuffer*)calloc(chunk, sizeof(OutputBuffer));
+    WorkerContext* workers = (WorkerContext*)calloc(numThreads, sizeof(WorkerContext));
+    Thread** threads = (Thread**)calloc(numThreads, sizeof(Thread*));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 3);
+    bool ok = outputs && workers && threads;
+
+    BatchContext batch;
+    batch.graph = graph;
+    for (int t = 0; ok && t < numThreads; t++) {
+        workers[t].batch = &batch;
+        workers[t].scratch = create_scratch(graph);
+        if (!workers[t].scratch) ok = false;
+    }
+
+    int done = 0;
+    while (ok && done < count) {
+        batch.queries = queries + done;
+        batch.outputs = outputs;
+        batch.count = count - done < chunk ? count - done : chunk;
+        batch.next = 0;
+
+        // A thread atual tambem executa consultas; so sao criadas numThreads - 1 threads
+        for (int t = 1; t < numThreads; t++) threads[t] = thread_start(query_worker, &workers[t]);
+        query_worker(&workers[0]);
+        for (int t = 1; t < numThreads; t++) thread_join(threads[t]);
+
+        for (int i = 0; i < batch.count; i++) {
+            if (outputs[i].failed) ok = false;
+            if (outputs[i].len) fwrite(outputs[i].data, 1, outputs[i].len, out);
+            outputs[i].len = 0;
+        }
+        done += batch.count;
+    }
+
+    for (int i = 0; outputs && i < chunk; i++) free(outputs[i].data);
+    for (int t = 0; workers && t < numThreads; t++) free_scratch(workers[t].scratch);
+    free(outputs);
+    free(workers);
+    free(threads);
+    return ok ? done : -1;
+}
+
+#pragma endregion
+
+#pragma region Leitura de consultas
+
+/**
+ * Funcao para interpretar uma linha de consulta.
+ *
+ * \param line - linha de texto
+ * \param query - consulta lida
+ * \return true se a linha e uma consulta valida
+ */
+bool parse_query(const char* line, Query* query) {
+    char name[16];
+    int consumed = 0;
+    if (sscanf(line, "%15s%n", name, &consumed) != 1) return false;
+    line += consumed;
+    memset(query, 0, sizeof(Query));
+
+    if (strcmp(name, "dfs") == 0 || strcmp(name, "bfs") == 0) {
+        query->kind = name[0] == 'd' ? QUERY_DFS : QUERY_BFS;
+        return sscanf(line, "%d %d", &query->row, &query->col) == 2;
+    }
+    if (strcmp(name, "paths") == 0) {
+        query->kind = QUERY_PATHS;
+        return sscanf(line, "%d %d %d %d", &query->row, &query->col, &query->endRow, &query->endCol) == 4;
+    }
+    if (strcmp(name, "pathstats") == 0) {
+        query->kind = QUERY_PATH_STATS;
+        query->maxHops = -1;
+        int read = sscanf(line, "%d %d %d %d %d", &query->row, &query->col, &query->endRow, &query->endCol, &query->maxHops);
+        return read == 4 || read == 5;
+    }
+    if (strcmp(name, "intersections") == 0) {
+        query->kind = QUERY_INTERSECTIONS;
+        return sscanf(line, " %c %c %d", &query->typeA, &query->typeB, &query->maxDistance) == 3;
+    }
+    return false;
+}
+
+/**
+ * Funcao para ler um ficheiro de consultas.
+ *
+ * \param filename - nome do ficheiro
+ * \param count - numero de consultas lidas
+ * \return vetor de consultas ou NULL
+ */
+Query* read_queries_from_file(const char* filename, int* count) {
+    *count = 0;
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        printf("Erro ao abrir ficheiro: %s\n", filename);
+        return NULL;
+    }
+
+    int capacity = 64;
+    Query* queries = (Query*)malloc(sizeof(Query) * capacity);
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    char line[256];
+    int lineNumber = 0;
+
+    while (queries && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* start = line;
+        while (*start == ' ' || *start == '\t') start++;
+        if (*start == '\n' || *start == '\r' || *start == '\0' || *start == '#') continue;
+
+        if (*count == capacity) {
+            capacity *= 2;
+            Query* grown = (Query*)realloc(queries, sizeof(Query) * capacity);
+            INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+            if (!grown) {
+                free(queries);
+                queries = NULL;
+                break;
+            }
+            queries = grown;
+        }
+
+        if (parse_query(start, &queries[*count])) (*count)++;
+        else printf("Consulta invalida na linha %d: %s", lineNumber, start);
+    }
+    fclose(file);
+    if (!queries) *count = 0;
+    return queries;
+}
+
+/**
+ * Funcao para ler e executar um ficheiro de consultas.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param filename - nome do ficheiro
+ * \param numThreads - numero de threads (0 = numero de processadores)
+ * \param out - ficheiro de saida
+ * \return numero de consultas executadas ou -1
+ */
+int run_queries_from_file(Graph* graph, const char* filename, int numThreads, FILE* out) {
+    int count;
+    Query* queries = read_queries_from_file(filename, &count);
+    if (!queries) return -1;
+    int done = run_queries(graph, queries, count, numThreads, out);
+    free(queries);
+    return done;
+}
+
+#pragma endregion
@@ -0,0 +1,89 @@
+/**
+ * @file QueryHandler.h
+ * @brief Execucao em lote de consultas (DFS, BFS, caminhos e intersecoes) sobre um grafo ja carregado.
+ *
+ * As consultas podem vir de um vetor ou de um ficheiro de texto com uma consulta por linha:
+ *
+ *     dfs <linha> <coluna>
+ *     bfs <linha> <coluna>
+ *     paths <linha> <coluna> <linha destino> <coluna destino>
+ *     pathstats <linha> <coluna> <linha destino> <coluna destino> [saltos maximos]
+ *     intersections <tipo A> <tipo B> <distancia maxima>
+ *
+ * As coordenadas sao de base 1, como em dfs, bfs e find_all_paths. Linhas vazias e
+ * linhas comecadas por '#' sao ignoradas.
+ *
+ * Cada thread usa o seu TraversalScratch, alocado uma vez para todo o lote. O resultado
+ * de cada consulta tem o mesmo texto que a funcao de impressao correspondente e e escrito
+ * pela ordem das consultas, independentemente do numero de threads.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef QUERY_HANDLER_H
+#define QUERY_HANDLER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "GraphHandler.h"
+
+#pragma region Structs
+
+/**
+ * @brief Tipo de consulta.
+ */
+typedef enum QueryKind {
+    QUERY_DFS,            /**< dfs */
+    QUERY_BFS,            /**< bfs */
+    QUERY_PATHS,          /**< find_all_paths */
+    QUERY_PATH_STATS,     /**< print_path_stats */
+    QUERY_INTERSECTIONS   /**< find_intersections */
+} QueryKind;
+
+/**
+ * @struct Query
+ * @brief Descritor de uma consulta.
+ */
+typedef struct Query {
+    QueryKind kind;       /**< Tipo de consulta */
+    int row, col;         /**< Antena de inicio (base 1) */
+    int endRow, endCol;   /**< Antena de destino (base 1, so QUERY_PATHS e QUERY_PATH_STATS) */
+    int maxHops;          /**< Limite de saltos (so QUERY_PATH_STATS, < 0 sem limite) */
+    char typeA, typeB;    /**< Tipos de antena (so QUERY_INTERSECTIONS) */
+    int maxDistance;      /**< Distancia maxima (so QUERY_INTERSECTIONS) */
+} Query;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Interpreta uma linha no formato do ficheiro de consultas.
+ * @return true se a linha descreve uma consulta valida.
+ */
+bool parse_query(const char* line, Query* query);
+
+/**
+ * @brief Le um ficheiro de consultas. As linhas invalidas sao indicadas e ignoradas.
+ * @param count Numero de consultas lidas.
+ * @return Vetor de consultas (libertar com free) ou NULL se o ficheiro nao abrir.
+ */
+Query* read_queries_from_file(const char* filename, int* count);
+
+/**
+ * @brief Executa as consultas sobre o grafo e escreve os resultados em out, pela ordem dada.
+ * @param numThreads Numero de threads (0 usa o numero de processadores; 1 executa na thread atual).
+ * @return Numero de consultas executadas ou -1 se faltar memoria.
+ */
+int run_queries(Graph* graph, const Query* queries, int count, int numThreads, FILE* out);
+
+/**
+ * @brief Le um ficheiro de consultas e executa-as com run_queries.
+ * @return Numero de consultas executadas ou -1 em caso de erro.
+ */
+int run_queries_from_file(Graph* graph, const char* filename, int numThreads, FILE* out);
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,956 @@
+/**
+ * @file SnapshotHandler.c
+ * @brief Implementacao das versoes imutaveis do grafo e da reclamacao por epocas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "SnapshotHandler.h"
+#include "ThreadHandler.h"
+#include "Instrumentation.h"
+
+#pragma region Blocos de vertices
+
+/**
+ * Funcao para criar um bloco vazio (todos os IDs vazios).
+ *
+ * \return bloco criado ou NULL
+ */
+static VersionBlock* block_create(void) {
+    VersionBlock* block = (VersionBlock*)calloc(1, sizeof(VersionBlock));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!block) return NULL;
+    block->refs = 1;
+    for (int i = 0; i < VERSION_BLOCK_SIZE; i++) block->vertices[i].id = -1;
+    return block;
+}
+
+/**
+ * Funcao para copiar um bloco (a copia pertence apenas a quem a pediu).
+ *
+ * \param block - bloco original
+ * \return copia ou NULL
+ */
+static VersionBlock* block_copy(const VersionBlock* block) {
+    VersionBlock* copy = (VersionBlock*)malloc(sizeof(VersionBlock));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!copy) return NULL;
+    memcpy(copy, block, sizeof(VersionBlock));
+    copy->refs = 1;
+
+    int total = block->offsets[VERSION_BLOCK_SIZE];
+    copy->targets = NULL;
+    if (total > 0) {
+        copy->targets = (int*)malloc(total * sizeof(int));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!copy->targets) {
+            free(copy);
+            return NULL;
+        }
+        memcpy(copy->targets, block->targets, total * sizeof(int));
+    }
+    return copy;
+}
+
+/**
+ * Funcao para largar uma referencia a um bloco, libertando-o se for a ultima.
+ *
+ * \param block - bloco
+ */
+static void block_release(VersionBlock* block) {
+    if (!block || --block->refs > 0) return;
+    free(block->targets);
+    free(block);
+}
+
+/**
+ * Funcao para substituir a lista de vizinhos de um vertice de um bloco privado.
+ *
+ * \param block - bloco (refs == 1)
+ * \param local - posicao do vertice no bloco
+ * \param ids - novos vizinhos
+ * \param n - numero de vizinhos
+ * \return false se faltar memoria
+ */
+static bool block_set_neighbours(VersionBlock* block, int local, const int* ids, int n) {
+    int start = block->offsets[local];
+    int oldCount = block->offsets[local + 1] - start;
+    int total = block->offsets[VERSION_BLOCK_SIZE];
+    int newTotal = total - oldCount + n;
+
+    int* targets = NULL;
+    if (newTotal > 0) {
+        targets = (int*)malloc(newTotal * sizeof(int));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!targets) return false;
+        if (start > 0) memcpy(targets, block->targets, start * sizeof(int));
+        if (n > 0) memcpy(targets + start, ids, n * sizeof(int));
+        if (total - start - oldCount > 0)
+            memcpy(targets + start + n, block->targets + start + oldCount, (total - start - oldCount) * sizeof(int));
+    }
+    free(block->targets);
+    block->targets = targets;
+    for (int i = local + 1; i <= VERSION_BLOCK_SIZE; i++) block->offsets[i] += n - oldCount;
+    return true;
+}
+
+/**
+ * Funcao para retirar vizinhos da lista de um vertice de um bloco privado, sem alocar memoria.
+ * O espaco libertado em targets so e devolvido na proxima alteracao do bloco.
+ *
+ * \param block - bloco (refs == 1)
+ * \param local - posicao do vertice no bloco
+ * \param first - posicao do primeiro vizinho a retirar na lista do vertice
+ * \param count - numero de vizinhos a retirar
+ */
+static void block_cut_neighbours(VersionBlock* block, int local, int first, int count) {
+    int start = block->offsets[local] + first;
+    int total = block->offsets[VERSION_BLOCK_SIZE];
+    if (count <= 0) return;
+    memmove(block->targets + start, block->targets + start + count, (total - start - count) * sizeof(int));
+    for (int i = local + 1; i <= VERSION_BLOCK_SIZE; i++) block->offsets[i] -= count;
+}
+
+#pragma endregion
+
+#pragma region Faixas do indice
+
+/**
+ * Funcao para criar uma faixa vazia.
+ *
+ * \return faixa criada ou NULL
+ */
+static IndexBand* band_create(void) {
+    IndexBand* band = (IndexBand*)calloc(1, sizeof(IndexBand));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (band) band->refs = 1;
+    return band;
+}
+
+/**
+ * Funcao para copiar uma faixa.
+ *
+ * \param band - faixa original
+ * \return copia ou NULL
+ */
+static IndexBand* band_copy(const IndexBand* band) {
+    IndexBand* copy = band_create();
+    if (!copy) return NULL;
+    if (band->count > 0) {
+        copy->entries = (IndexEntry*)malloc(band->count * sizeof(IndexEntry));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!copy->entries) {
+            free(copy);
+            return NULL;
+        }
+        memcpy(copy->entries, band->entries, band->count * sizeof(IndexEntry));
+    }
+    copy->count = band->count;
+    copy->capacity = band->count;
+    return copy;
+}
+
+/**
+ * Funcao para largar uma referencia a uma faixa.
+ *
+ * \param band - faixa (pode ser NULL)
+ */
+static void band_release(IndexBand* band) {
+    if (!band || --band->refs > 0) return;
+    free(band->entries);
+    free(band);
+}
+
+/**
+ * Funcao para encontrar a primeira entrada >= (row, col) numa faixa.
+ *
+ * \param band - faixa
+ * \param row - linha
+ * \param col - coluna
+ * \return posicao da entrada
+ */
+static int band_lower_bound(const IndexBand* band, int row, int col) {
+    int lo = 0, hi = band->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        const IndexEntry* e = &band->entries[mid];
+        if (e->row < row || (e->row == row && e->col < col)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * Funcao para inserir uma entrada numa faixa privada, mantendo a ordem.
+ *
+ * \param band - faixa (refs == 1)
+ * \param entry - entrada
+ * \return false se faltar memoria
+ */
+static bool band_insert(IndexBand* band, const IndexEntry* entry) {
+    if (band->count == band->capacity) {
+        int capacity = band->capacity ? band->capacity * 2 : 16;
+        IndexEntry* entries = (IndexEntry*)realloc(band->entries, capacity * sizeof(IndexEntry));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!entries) return false;
+        band->entries = entries;
+        band->capacity = capacity;
+    }
+    int pos = band_lower_bound(band, entry->row, entry->col);
+    memmove(&band->entries[pos + 1], &band->entries[pos], (band->count - pos) * sizeof(IndexEntry));
+    band->entries[pos] = *entry;
+    band->count++;
+    return true;
+}
+
+/**
+ * Funcao para ordenar entradas por (linha, coluna).
+ */
+static int compare_entries(const void* a, const void* b) {
+    const IndexEntry* x = (const IndexEntry*)a;
+    const IndexEntry* y = (const IndexEntry*)b;
+    if (x->row != y->row) return x->row < y->row ? -1 : 1;
+    if (x->col != y->col) return x->col < y->col ? -1 : 1;
+    return 0;
+}
+
+#pragma endregion
+
+#pragma region Versoes
+
+/**
+ * Funcao para libertar uma versao, largando as referencias aos blocos e faixas.
+ *
+ * \param version - versao
+ */
+static void version_release(GraphVersion* version) {
+    if (!version) return;
+    for (int b = 0; b < version->numBlocks; b++) block_release(version->blocks[b]);
+    for (int b = 0; b < version->numBands; b++) band_release(version->bands[b]);
+    free(version->blocks);
+    free(version->bands);
+    free(version);
+}
+
+/**
+ * Funcao para obter um bloco do rascunho que possa ser alterado, copiando-o se for partilhado.
+ *
+ * \param draft - rascunho
+ * \param b - indice do bloco
+ * \return bloco privado ou NULL
+ */
+static VersionBlock* draft_block(GraphVersion* draft, int b) {
+    VersionBlock* block = draft->blocks[b];
+    if (block->refs > 1) {
+        VersionBlock* copy = block_copy(block);
+        if (!copy) return NULL;
+        block->refs--;
+        draft->blocks[b] = copy;
+        block = copy;
+    }
+    return block;
+}
+
+/**
+ * Funcao para obter uma faixa do rascunho que possa ser alterada, criando-a ou copiando-a.
+ *
+ * \param draft - rascunho
+ * \param b - indice da faixa
+ * \return faixa privada ou NULL
+ */
+static IndexBand* draft_band(GraphVersion* draft, int b) {
+    if (b >= draft->numBands) {
+        IndexBand** bands = (IndexBand**)realloc(draft->bands, (b + 1) * sizeof(IndexBand*));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!bands) return NULL;
+        for (int i = draft->numBands; i <= b; i++) bands[i] = NULL;
+        draft->bands = bands;
+        draft->numBands = b + 1;
+    }
+
+    IndexBand* band = draft->bands[b];
+    if (!band) {
+        band = band_create();
+        draft->bands[b] = band;
+    }
+    else if (band->refs > 1) {
+        IndexBand* copy = band_copy(band);
+        if (!copy) return NULL;
+        band->refs--;
+        draft->bands[b] = copy;
+        band = copy;
+    }
+    return band;
+}
+
+/**
+ * Funcao para acrescentar ou remover um vizinho da lista de um vertice do rascunho.
+ * As listas sao mantidas por ordem decrescente de ID, como em read_graph_from_file.
+ *
+ * \param draft - rascunho
+ * \param id - vertice cuja lista muda
+ * \param neighbour - vizinho
+ * \param add - true para acrescentar, false para remover
+ * \return false se faltar memoria
+ */
+static bool draft_update_neighbour(GraphVersion* draft, int id, int neighbour, bool add) {
+    VersionBlock* block = draft_block(draft, id / VERSION_BLOCK_SIZE);
+    if (!block) return false;
+    int local = id % VERSION_BLOCK_SIZE;
+    int start = block->offsets[local];
+    int count = block->offsets[local + 1] - start;
+
+    int* ids = (int*)malloc((count + 1) * sizeof(int));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!ids) return false;
+    int n = 0;
+    bool placed = !add;
+    for (int i = 0; i < count; i++) {
+        int target = block->targets[start + i];
+        if (!placed && neighbour > target) {
+            ids[n++] = neighbour;
+            placed = true;
+        }
+        if (add || target != neighbour) ids[n++] = target;
+    }
+    if (!placed) ids[n++] = neighbour;
+
+    bool ok = block_set_neighbours(block, local, ids, n);
+    free(ids);
+    return ok;
+}
+
+/**
+ * Funcao para retirar um vizinho da lista de um vertice do rascunho cujo bloco ja e privado.
+ * Nao aloca memoria, por isso pode desfazer uma edicao interrompida por falta de memoria.
+ *
+ * \param draft - rascunho
+ * \param id - vertice cuja lista muda (bloco com refs == 1)
+ * \param neighbour - vizinho a retirar
+ */
+static void draft_cut_neighbour(GraphVersion* draft, int id, int neighbour) {
+    VersionBlock* block = draft->blocks[id / VERSION_BLOCK_SIZE];
+    int local = id % VERSION_BLOCK_SIZE;
+    int start = block->offsets[local];
+    int count = block->offsets[local + 1] - start;
+    for (int i = 0; i < count; i++) {
+        if (block->targets[start + i] == neighbour) {
+            block_cut_neighbours(block, local, i, 1);
+            return;
+        }
+    }
+}
+
+/**
+ * Funcao para ordenar IDs por ordem decrescente.
+ */
+static int compare_ids_desc(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x < y) - (x > y);
+}
+
+#pragma endregion
+
+#pragma region Criacao e libertacao
+
+/**
+ * Funcao para criar um grafo com versoes a partir de um grafo existente.
+ * Um grafo lazy e expandido antes da copia.
+ *
+ * \param graph - grafo de origem
+ * \return grafo com versoes ou NULL
+ */
+VersionedGraph* versioned_graph_create(Graph* graph) {
+    expand_graph(graph);
+
+    VersionedGraph* vgraph = (VersionedGraph*)calloc(1, sizeof(VersionedGraph));
+    GraphVersion* version = (GraphVersion*)calloc(1, sizeof(GraphVersion));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    if (!vgraph || !version) {
+        free(vgraph);
+        free(version);
+        return NULL;
+    }
+    for (int i = 0; i < SNAPSHOT_MAX_READERS; i++) vgraph->pinned[i] = -1;
+    vgraph->radius = GRAPH_RADIUS;
+
+    int n = graph->numVertices;
+    version->numIds = n;
+    version->numBlocks = (n + VERSION_BLOCK_SIZE - 1) / VERSION_BLOCK_SIZE;
+    version->blocks = (VersionBlock**)calloc(version->numBlocks > 0 ? version->numBlocks : 1, sizeof(VersionBlock*));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    bool ok = version->blocks != NULL;
+
+    for (int b = 0; ok && b < version->numBlocks; b++) {
+        VersionBlock* block = block_create();
+        version->blocks[b] = block;
+        if (!block) {
+            ok = false;
+            break;
+        }
+
+        int total = 0;
+        for (int i = 0; i < VERSION_BLOCK_SIZE; i++) {
+            int id = b * VERSION_BLOCK_SIZE + i;
+            block->offsets[i] = total;
+            if (id >= n || !graph->byId[id]) continue;
+            for (Edge* edge = get_neighbours(graph, id); edge; edge = edge->next) total++;
+        }
+        block->offsets[VERSION_BLOCK_SIZE] = total;
+        block->targets = total > 0 ? (int*)malloc(total * sizeof(int)) : NULL;
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (total > 0 && !block->targets) {
+            ok = false;
+            break;
+        }
+
+        for (int i = 0; i < VERSION_BLOCK_SIZE; i++) {
+            int id = b * VERSION_BLOCK_SIZE + i;
+            if (id >= n || !graph->byId[id]) continue;
+            block->vertices[i] = *graph->byId[id];
+            block->vertices[i].next = NULL;
+            version->numVertices++;
+            int k = block->offsets[i];
+            for (Edge* edge = get_neighbours(graph, id); edge; edge = edge->next) block->targets[k++] = edge->destId;
+        }
+    }
+
+    for (int id = 0; ok && id < n; id++) {
+        const Vertex* vertex = graph->byId[id];
+        if (!vertex) continue;
+        int b = vertex->row / INDEX_BAND_ROWS;
+        IndexBand* band = draft_band(version, b);
+        if (!band) {
+            ok = false;
+            break;
+        }
+        // Acrescenta no fim; cada faixa e ordenada no fim
+        if (band->count == band->capacity) {
+            int capacity = band->capacity ? band->capacity * 2 : 16;
+            IndexEntry* entries = (IndexEntry*)realloc(band->entries, capacity * sizeof(IndexEntry));
+            INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+            if (!entries) {
+                ok = false;
+                break;
+            }
+            band->entries = entries;
+            band->capacity = capacity;
+        }
+        IndexEntry entry = { vertex->row, vertex->col, vertex->id, vertex->type };
+        band->entries[band->count++] = entry;
+    }
+    for (int b = 0; ok && b < version->numBands; b++) {
+        if (version->bands[b]) qsort(version->bands[b]->entries, version->bands[b]->count, sizeof(IndexEntry), compare_entries);
+    }
+
+    if (!ok) {
+        version_release(version);
+        free(vgraph);
+        return NULL;
+    }
+    vgraph->current = version;
+    return vgraph;
+}
+
+/**
+ * Funcao para libertar o grafo com versoes.
+ *
+ * \param vgraph - grafo com versoes
+ */
+void versioned_graph_free(VersionedGraph* vgraph) {
+    if (!vgraph) return;
+    GraphVersion* retired = vgraph->retired;
+    while (retired) {
+        GraphVersion* next = retired->nextRetired;
+        version_release(retired);
+        retired = next;
+    }
+    version_release((GraphVersion*)vgraph->current);
+    free(vgraph);
+}
+
+#pragma endregion
+
+#pragma region Leitores
+
+/**
+ * Funcao para registar um leitor.
+ *
+ * \param vgraph - grafo com versoes
+ * \return lugar do leitor ou -1
+ */
+int snapshot_register_reader(VersionedGraph* vgraph) {
+    for (int i = 0; i < SNAPSHOT_MAX_READERS; i++) {
+        if (thread_atomic_cas(&vgraph->slots[i], 0, 1)) {
+            thread_atomic_store(&vgraph->pinned[i], -1);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Funcao para libertar o lugar de um leitor.
+ *
+ * \param vgraph - grafo com versoes
+ * \param slot - lugar do leitor
+ */
+void snapshot_unregister_reader(VersionedGraph* vgraph, int slot) {
+    thread_atomic_store(&vgraph->pinned[slot], -1);
+    thread_atomic_store(&vgraph->slots[slot], 0);
+}
+
+/**
+ * Funcao para fixar a versao atual.
+ * O leitor anuncia a epoca antes de ler a versao: qualquer versao que possa ler
+ * foi retirada numa epoca >= a anunciada, e por isso nao e libertada.
+ *
+ * \param vgraph - grafo com versoes
+ * \param slot - lugar do leitor
+ * \return versao fixada
+ */
+const GraphVersion* snapshot_pin(VersionedGraph* vgraph, int slot) {
+    thread_atomic_store(&vgraph->pinned[slot], thread_atomic_load(&vgraph->epoch));
+    return (const GraphVersion*)thread_atomic_load_ptr(&vgraph->current);
+}
+
+/**
+ * Funcao para libertar a versao fixada por um leitor.
+ *
+ * \param vgraph - grafo com versoes
+ * \param slot - lugar do leitor
+ */
+void snapshot_unpin(VersionedGraph* vgraph, int slot) {
+    thread_atomic_store(&vgraph->pinned[slot], -1);
+}
+
+#pragma endregion
+
+#pragma region Escritor
+
+/**
+ * Funcao para criar um rascunho a partir da versao atual.
+ *
+ * \param vgraph - grafo com versoes
+ * \return rascunho ou NULL
+ */
+GraphVersion* version_begin(VersionedGraph* vgraph) {
+    const GraphVersion* current = (const GraphVersion*)vgraph->current;
+    GraphVersion* draft = (GraphVersion*)calloc(1, sizeof(GraphVersion));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!draft) return NULL;
+
+    *draft = *current;
+    draft->number = current->number + 1;
+    draft->nextRetired = NULL;
+    draft->blocks = (VersionBlock**)malloc((current->numBlocks > 0 ? current->numBlocks : 1) * sizeof(VersionBlock*));
+    draft->bands = (IndexBand**)malloc((current->numBands > 0 ? current->numBands : 1) * sizeof(IndexBand*));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    if (!draft->blocks || !draft->bands) {
+        free(draft->blocks);
+        free(draft->bands);
+        free(draft);
+        return NULL;
+    }
+
+    for (int b = 0; b < current->numBlocks; b++) {
+        draft->blocks[b] = current->blocks[b];
+        draft->blocks[b]->refs++;
+    }
+    for (int b = 0; b < current->numBands; b++) {
+        draft->bands[b] = current->bands[b];
+        if (draft->bands[b]) draft->bands[b]->refs++;
+    }
+    return draft;
+}
+
+/**
+ * Funcao para acrescentar uma antena ao rascunho.
+ *
+ * \param vgraph - grafo com versoes
+ * \param draft - rascunho
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \param type - tipo da antena
+ * \return ID da antena ou -1
+ */
+int version_insert_antenna(VersionedGraph* vgraph, GraphVersion* draft, int row, int col, char type) {
+    if (row < 0 || col < 0 || version_find_vertex_id(draft, row, col) != -1) return -1;
+
+    int id = draft->numIds;
+    int b = id / VERSION_BLOCK_SIZE;
+    if (b == draft->numBlocks) {
+        VersionBlock** blocks = (VersionBlock**)realloc(draft->blocks, (b + 1) * sizeof(VersionBlock*));
+        INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+        if (!blocks) return -1;
+        draft->blocks = blocks;
+        draft->blocks[b] = block_create();
+        if (!draft->blocks[b]) return -1;
+        draft->numBlocks++;
+    }
+
+    // Vizinhos: antenas do mesmo tipo a distancia de Manhattan <= radius
+    int radius = vgraph->radius;
+    int* ids = (int*)malloc((2 * radius * (radius + 1) + 1) * sizeof(int));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!ids) return -1;
+    int n = 0;
+    int firstBand = row - radius > 0 ? (row - radius) / INDEX_BAND_ROWS : 0;
+    int lastBand = (row + radius) / INDEX_BAND_ROWS;
+    for (int bb = firstBand; bb <= lastBand && bb < draft->numBands; bb++) {
+        const IndexBand* band = draft->bands[bb];
+        for (int i = 0; band && i < band->count; i++) {
+            const IndexEntry* e = &band->entries[i];
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (e->type == type && manhattan_distance(row, col, e->row, e->col) <= radius) ids[n++] = e->id;
+        }
+    }
+    qsort(ids, n, sizeof(int), compare_ids_desc);
+
+    // O ID ainda nao foi atribuido (numIds), por isso a posicao do vertice so fica visivel no fim
+    int local = id % VERSION_BLOCK_SIZE;
+    VersionBlock* block = draft_block(draft, b);
+    if (!block || !block_set_neighbours(block, local, ids, n)) {
+        free(ids);
+        return -1;
+    }
+    Vertex vertex = { id, row, col, type, NULL };
+    block->vertices[local] = vertex;
+
+    int linked = 0;
+    while (linked < n && draft_update_neighbour(draft, ids[linked], id, true)) linked++;
+    IndexBand* band = linked == n ? draft_band(draft, row / INDEX_BAND_ROWS) : NULL;
+    IndexEntry entry = { row, col, id, type };
+    if (!band || !band_insert(band, &entry)) {
+        // Desfaz o que ja foi feito: os blocos alterados sao privados e retirar nao aloca memoria
+        for (int i = 0; i < linked; i++) draft_cut_neighbour(draft, ids[i], id);
+        block_cut_neighbours(block, local, 0, n);
+        block->vertices[local].id = -1;
+        free(ids);
+        return -1;
+    }
+    free(ids);
+
+    draft->numIds++;
+    draft->numVertices++;
+    return id;
+}
+
+/**
+ * Funcao para remover uma antena do rascunho.
+ *
+ * \param vgraph - grafo com versoes
+ * \param draft - rascunho
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \return ID da antena removida ou -1
+ */
+int version_delete_antenna(VersionedGraph* vgraph, GraphVersion* draft, int row, int col) {
+    (void)vgraph;
+    int id = version_find_vertex_id(draft, row, col);
+    if (id == -1) return -1;
+
+    // Primeiro tornam-se privados todos os blocos e a faixa a alterar, o unico passo que pode
+    // falhar; as copias sao iguais aos originais, por isso uma falha nao altera o rascunho
+    int local = id % VERSION_BLOCK_SIZE;
+    VersionBlock* block = draft_block(draft, id / VERSION_BLOCK_SIZE);
+    if (!block) return -1;
+    const int* neighbours;
+    int n = version_neighbours(draft, id, &neighbours);
+    int* ids = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!ids) return -1;
+    memcpy(ids, neighbours, n * sizeof(int));
+
+    bool ok = true;
+    for (int i = 0; ok && i < n; i++) ok = draft_block(draft, ids[i] / VERSION_BLOCK_SIZE) != NULL;
+    IndexBand* band = ok ? draft_band(draft, row / INDEX_BAND_ROWS) : NULL;
+    if (!band) {
+        free(ids);
+        return -1;
+    }
+
+    // Depois so se retiram entradas, o que nao aloca memoria
+    for (int i = 0; i < n; i++) draft_cut_neighbour(draft, ids[i], id);
+    free(ids);
+    block_cut_neighbours(block, local, 0, n);
+    block->vertices[local].id = -1;
+
+    int pos = band_lower_bound(band, row, col);
+    memmove(&band->entries[pos], &band->entries[pos + 1], (band->count - pos - 1) * sizeof(IndexEntry));
+    band->count--;
+
+    draft->numVertices--;
+    return id;
+}
+
+/**
+ * Funcao para libertar as versoes retiradas que ja nao podem estar fixadas por nenhum leitor.
+ *
+ * \param vgraph - grafo com versoes
+ */
+static void reclaim_versions(VersionedGraph* vgraph) {
+    long oldest = LONG_MAX;
+    for (int i = 0; i < SNAPSHOT_MAX_READERS; i++) {
+        long pinned = thread_atomic_load(&vgraph->pinned[i]);
+        if (pinned != -1 && pinned < oldest) oldest = pinned;
+    }
+
+    GraphVersion** link = &vgraph->retired;
+    while (*link) {
+        GraphVersion* version = *link;
+        if (version->retiredAt < oldest) {
+            *link = version->nextRetired;
+            version_release(version);
+        }
+        else {
+            link = &version->nextRetired;
+        }
+    }
+}
+
+/**
+ * Funcao para publicar um rascunho como versao atual.
+ *
+ * \param vgraph - grafo com versoes
+ * \param draft - rascunho
+ */
+void version_publish(VersionedGraph* vgraph, GraphVersion* draft) {
+    GraphVersion* old = (GraphVersion*)vgraph->current;
+    thread_atomic_store_ptr(&vgraph->current, draft);
+
+    // Um leitor que anuncie uma epoca posterior a esta ja le a nova versao
+    old->retiredAt = thread_atomic_load(&vgraph->epoch);
+    old->nextRetired = vgraph->retired;
+    vgraph->retired = old;
+    thread_atomic_add(&vgraph->epoch, 1);
+
+    reclaim_versions(vgraph);
+}
+
+/**
+ * Funcao para descartar um rascunho.
+ *
+ * \param draft - rascunho
+ */
+void version_discard(GraphVersion* draft) {
+    version_release(draft);
+}
+
+#pragma endregion
+
+#pragma region Consultas
+
+/**
+ * Funcao para procurar o ID do vertice numas coordenadas.
+ *
+ * \param version - versao
+ * \param row - linha (base 0)
+ * \param col - coluna (base 0)
+ * \return ID ou -1
+ */
+int version_find_vertex_id(const GraphVersion* version, int row, int col) {
+    if (row < 0) return -1;
+    int b = row / INDEX_BAND_ROWS;
+    if (b >= version->numBands || !version->bands[b]) return -1;
+
+    const IndexBand* band = version->bands[b];
+    int pos = band_lower_bound(band, row, col);
+    if (pos < band->count && band->entries[pos].row == row && band->entries[pos].col == col)
+        return band->entries[pos].id;
+    return -1;
+}
+
+/**
+ * Funcao para obter o vertice com um dado ID.
+ *
+ * \param version - versao
+ * \param id - ID do vertice
+ * \return vertice ou NULL
+ */
+const Vertex* version_get_vertex(const GraphVersion* version, int id) {
+    if (id < 0 || id >= version->numIds) return NULL;
+    const Vertex* vertex = &version->blocks[id / VERSION_BLOCK_SIZE]->vertices[id % VERSION_BLOCK_SIZE];
+    return vertex->id == -1 ? NULL : vertex;
+}
+
+/**
+ * Funcao para obter os vizinhos de um vertice.
+ *
+ * \param version - versao
+ * \param id - ID do vertice
+ * \param neighbours - IDs dos vizinhos
+ * \return numero de vizinhos
+ */
+int version_neighbours(const GraphVersion* version, int id, const int** neighbours) {
+    if (id < 0 || id >= version->numIds) {
+        *neighbours = NULL;
+        return 0;
+    }
+    const VersionBlock* block = version->blocks[id / VERSION_BLOCK_SIZE];
+    int local = id % VERSION_BLOCK_SIZE;
+    *neighbours = block->targets + block->offsets[local];
+    return block->offsets[local + 1] - block->offsets[local];
+}
+
+/**
+ * Funcao para realizar DFS numa versao a partir de um vertice.
+ *
+ * \param version - versao
+ * \param id - ID do vertice
+ * \param depth - profundidade atual
+ * \param visited - array de visitados
+ * \param visitor - funcao chamada para cada vertice (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados
+ */
+static int version_dfs_from(const GraphVersion* version, int id, int depth, bool* visited,
+    VertexVisitor visitor, void* ctx) {
+    visited[id] = true;
+    int count = 1;
+    INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+    if (visitor) visitor(version_get_vertex(version, id), depth, ctx);
+
+    const int* neighbours;
+    int n = version_neighbours(version, id, &neighbours);
+    for (int i = 0; i < n; i++) {
+        INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+        if (!visited[neighbours[i]]) count += version_dfs_from(version, neighbours[i], depth + 1, visited, visitor, ctx);
+    }
+    return count;
+}
+
+/**
+ * Funcao para realizar DFS numa versao a partir de uma antena.
+ *
+ * \param version - versao
+ * \param start_row - linha de inicio (base 1)
+ * \param start_col - coluna de inicio (base 1)
+ * \param visitor - funcao chamada para cada vertice
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
+ */
+int version_dfs_visit(const GraphVersion* version, int start_row, int start_col, VertexVisitor visitor, void* ctx) {
+    int startId = version_find_vertex_id(version, start_row - 1, start_col - 1);
+    if (startId == -1) return -1;
+
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    bool* visited = (bool*)calloc(version->numIds, sizeof(bool));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!visited) {
+        INSTR_PHASE_END(PHASE_TRAVERSAL);
+        return -1;
+    }
+    int count = version_dfs_from(version, startId, 0, visited, visitor, ctx);
+    free(visited);
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return count;
+}
+
+/**
+ * Funcao para realizar BFS numa versao a partir de uma antena.
+ *
+ * \param version - versao
+ * \param start_row - linha de inicio (base 1)
+ * \param start_col - coluna de inicio (base 1)
+ * \param visitor - funcao chamada para cada vertice
+ * \param ctx - contexto passado ao visitor
+ * \return numero de vertices visitados ou -1
+ */
+int version_bfs_visit(const GraphVersion* version, int start_row, int start_col, VertexVisitor visitor, void* ctx) {
+    int startId = version_find_vertex_id(version, start_row - 1, start_col - 1);
+    if (startId == -1) return -1;
+
+    INSTR_PHASE_BEGIN(PHASE_TRAVERSAL);
+    int* dist = (int*)malloc(version->numIds * sizeof(int));
+    int* queue = (int*)malloc(version->numIds * sizeof(int));
+    INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+    if (!dist || !queue) {
+        free(dist);
+        free(queue);
+        INSTR_PHASE_END(PHASE_TRAVERSAL);
+        return -1;
+    }
+    for (int i = 0; i < version->numIds; i++) dist[i] = -1;
+
+    int head = 0, tail = 0;
+    queue[tail++] = startId;
+    dist[startId] = 0;
+    while (head < tail) {
+        int currentId = queue[head++];
+        INSTR_COUNT(INSTR_VERTICES_VISITED, 1);
+        if (visitor) visitor(version_get_vertex(version, currentId), dist[currentId], ctx);
+
+        const int* neighbours;
+        int n = version_neighbours(version, currentId, &neighbours);
+        for (int i = 0; i < n; i++) {
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (dist[neighbours[i]] == -1) {
+                dist[neighbours[i]] = dist[currentId] + 1;
+                queue[tail++] = neighbours[i];
+            }
+        }
+    }
+
+    free(dist);
+    free(queue);
+    INSTR_PHASE_END(PHASE_TRAVERSAL);
+    return tail;
+}
+
+/**
+ * Funcao para encontrar intersecoes entre dois tipos de antenas numa versao.
+ * Para cada origem so sao percorridas as faixas do indice com linhas a distancia <= maxDistance.
+ *
+ * \param version - versao
+ * \param typeA - tipo da antena A
+ * \param typeB - tipo da antena B
+ * \param maxDistance - distancia maxima
+ * \param visitor - funcao chamada para cada intersecao (pode ser NULL)
+ * \param ctx - contexto passado ao visitor
+ * \return numero de intersecoes encontradas
+ */
+int version_find_intersections_visit(const GraphVersion* version, char typeA, char typeB, int maxDistance,
+    IntersectionVisitor visitor, void* ctx) {
+    int count = 0;
+    if (maxDistance < 0) return 0;
+    INSTR_PHASE_BEGIN(PHASE_INTERSECTIONS);
+
+    for (int id = 0; id < version->numIds; id++) {
+        const Vertex* source = version_get_vertex(version, id);
+        if (!source || source->type != typeA) continue;
+
+        int firstRow = source->row - maxDistance > 0 ? source->row - maxDistance : 0;
+        int lastRow = source->row + maxDistance;
+        int firstBand = firstRow / INDEX_BAND_ROWS;
+        int lastBand = lastRow / INDEX_BAND_ROWS < version->numBands ? lastRow / INDEX_BAND_ROWS : version->numBands - 1;
+
+        for (int b = firstBand; b <= lastBand; b++) {
+            const IndexBand* band = version->bands[b];
+            if (!band) continue;
+            int start = b == firstBand ? band_lower_bound(band, firstRow, INT_MIN) : 0;
+            for (int i = start; i < band->count && band->entries[i].row <= lastRow; i++) {
+                const IndexEntry* e = &band->entries[i];
+                INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+                if (e->type != typeB) continue;
+                int dist = manhattan_distance(source->row, source->col, e->row, e->col);
+                if (dist > maxDistance) continue;
+                if (visitor) visitor(source, version_get_vertex(version, e->id), dist, ctx);
+                count++;
+            }
+        }
+    }
+
+    INSTR_PHASE_END(PHASE_INTERSECTIONS);
+    return count;
+}
+
+#pragma endregion
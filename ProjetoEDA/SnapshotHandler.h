@@ -0,0 +1,221 @@
+/**
+ * @file SnapshotHandler.h
+ * @brief Versoes imutaveis do grafo (copy-on-write) para leitores concorrentes sem locks.
+ *
+ * Cada GraphVersion e imutavel depois de publicada. Os vertices e as listas de adjacencia
+ * estao divididos em blocos de VERSION_BLOCK_SIZE IDs e o indice de coordenadas em faixas
+ * de INDEX_BAND_ROWS linhas. Uma nova versao partilha com a anterior todos os blocos e
+ * faixas que nao alterou; so os blocos tocados por uma edicao sao copiados.
+ *
+ * Leitores: cada thread regista um lugar (snapshot_register_reader) e, para cada consulta,
+ * fixa a versao atual com snapshot_pin e liberta-a com snapshot_unpin. As consultas sobre
+ * uma versao fixada nao usam locks nem alteram memoria partilhada.
+ *
+ * Escritor: uma unica thread de cada vez cria um rascunho (version_begin), aplica edicoes
+ * e publica-o (version_publish). As versoes antigas sao libertadas por reclamacao baseada
+ * em epocas: uma versao retirada na epoca E so e libertada quando nenhum leitor anunciou
+ * uma epoca <= E. As contagens de referencias dos blocos so sao alteradas pelo escritor.
+ *
+ * Os IDs sao estaveis entre versoes: uma antena nova recebe o proximo ID livre e uma
+ * antena removida deixa o seu ID vazio.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef SNAPSHOT_HANDLER_H
+#define SNAPSHOT_HANDLER_H
+
+#include <stdbool.h>
+
+#include "GraphHandler.h"
+
+/** Numero de IDs por bloco de vertices e adjacencias. */
+#define VERSION_BLOCK_SIZE 256
+
+/** Numero de linhas do mapa por faixa do indice de coordenadas. */
+#define INDEX_BAND_ROWS 16
+
+/** Numero maximo de threads leitoras registadas em simultaneo. */
+#define SNAPSHOT_MAX_READERS 64
+
+#pragma region Structs
+
+/**
+ * @struct VersionBlock
+ * @brief Vertices e adjacencias de VERSION_BLOCK_SIZE IDs consecutivos.
+ * Os vizinhos do vertice i estao em targets[offsets[i] .. offsets[i + 1]).
+ */
+typedef struct VersionBlock {
+    int refs;                                 /**< Versoes que usam o bloco */
+    Vertex vertices[VERSION_BLOCK_SIZE];      /**< Vertices (id == -1 se o ID estiver vazio) */
+    int offsets[VERSION_BLOCK_SIZE + 1];      /**< Inicio da lista de cada vertice em targets */
+    int* targets;                             /**< IDs dos vizinhos de todos os vertices do bloco */
+} VersionBlock;
+
+/**
+ * @struct IndexEntry
+ * @brief Entrada do indice de coordenadas.
+ */
+typedef struct IndexEntry {
+    int row, col;         /**< Coordenadas (base 0) */
+    int id;               /**< ID do vertice */
+    char type;            /**< Tipo da antena */
+} IndexEntry;
+
+/**
+ * @struct IndexBand
+ * @brief Antenas de INDEX_BAND_ROWS linhas, ordenadas por (linha, coluna).
+ */
+typedef struct IndexBand {
+    int refs;             /**< Versoes que usam a faixa */
+    int count;            /**< Numero de entradas */
+    int capacity;         /**< Capacidade de entries */
+    IndexEntry* entries;  /**< Entradas ordenadas */
+} IndexBand;
+
+/**
+ * @struct GraphVersion
+ * @brief Versao imutavel do grafo.
+ */
+typedef struct GraphVersion {
+    long number;                  /**< Numero da versao (0 para a inicial) */
+    int numIds;                   /**< IDs atribuidos (incluindo os vazios) */
+    int numVertices;              /**< Antenas existentes */
+    int numBlocks;                /**< Numero de blocos */
+    VersionBlock** blocks;        /**< Blocos de vertices */
+    int numBands;                 /**< Numero de faixas */
+    IndexBand** bands;            /**< Faixas do indice (NULL se vazia) */
+    long retiredAt;               /**< Epoca em que foi substituida */
+    struct GraphVersion* nextRetired; /**< Proxima versao a aguardar libertacao */
+} GraphVersion;
+
+/**
+ * @struct VersionedGraph
+ * @brief Grafo com versoes: versao atual, leitores registados e versoes por libertar.
+ */
+typedef struct VersionedGraph {
+    void* volatile current;                       /**< Versao publicada (GraphVersion*) */
+    volatile long epoch;                          /**< Epoca global */
+    volatile long slots[SNAPSHOT_MAX_READERS];    /**< 1 se o lugar de leitor esta ocupado */
+    volatile long pinned[SNAPSHOT_MAX_READERS];   /**< Epoca anunciada por cada leitor (-1 se inativo) */
+    GraphVersion* retired;                        /**< Versoes substituidas ainda nao libertadas */
+    int radius;                                   /**< Distancia maxima das arestas */
+} VersionedGraph;
+
+#pragma endregion
+
+#pragma region Criacao e libertacao
+/**
+ * @brief Cria um grafo com versoes cuja versao 0 e uma copia de graph.
+ * Se graph for lazy, e expandido primeiro (expand_graph), por isso nao e const.
+ * @return Grafo criado ou NULL se faltar memoria.
+ */
+VersionedGraph* versioned_graph_create(Graph* graph);
+
+/**
+ * @brief Liberta o grafo e todas as versoes. Nao pode haver leitores ativos.
+ */
+void versioned_graph_free(VersionedGraph* vgraph);
+
+#pragma endregion
+
+#pragma region Leitores
+/**
+ * @brief Regista a thread atual como leitora.
+ * @return Lugar do leitor ou -1 se os SNAPSHOT_MAX_READERS lugares estiverem ocupados.
+ */
+int snapshot_register_reader(VersionedGraph* vgraph);
+
+/**
+ * @brief Liberta um lugar de leitor (sem versao fixada).
+ */
+void snapshot_unregister_reader(VersionedGraph* vgraph, int slot);
+
+/**
+ * @brief Fixa a versao atual. A versao nao e libertada ate snapshot_unpin.
+ */
+const GraphVersion* snapshot_pin(VersionedGraph* vgraph, int slot);
+
+/**
+ * @brief Liberta a versao fixada pelo leitor.
+ */
+void snapshot_unpin(VersionedGraph* vgraph, int slot);
+
+#pragma endregion
+
+#pragma region Escritor
+/**
+ * @brief Cria um rascunho a partir da versao atual, partilhando todos os blocos.
+ * @return Rascunho ou NULL se faltar memoria.
+ */
+GraphVersion* version_begin(VersionedGraph* vgraph);
+
+/**
+ * @brief Acrescenta uma antena ao rascunho e liga-a as antenas do mesmo tipo ate ao raio do grafo.
+ * @return ID da nova antena ou -1 se a posicao estiver ocupada ou faltar memoria
+ * (em ambos os casos o rascunho fica como estava).
+ */
+int version_insert_antenna(VersionedGraph* vgraph, GraphVersion* draft, int row, int col, char type);
+
+/**
+ * @brief Remove a antena na posicao indicada do rascunho, com as suas arestas.
+ * @return ID da antena removida ou -1 se nao existir ou faltar memoria
+ * (em ambos os casos o rascunho fica como estava).
+ */
+int version_delete_antenna(VersionedGraph* vgraph, GraphVersion* draft, int row, int col);
+
+/**
+ * @brief Publica o rascunho como versao atual e liberta as versoes que ja nao tem leitores.
+ */
+void version_publish(VersionedGraph* vgraph, GraphVersion* draft);
+
+/**
+ * @brief Descarta um rascunho sem o publicar.
+ */
+void version_discard(GraphVersion* draft);
+
+#pragma endregion
+
+#pragma region Consultas
+/**
+ * @brief Procura o ID do vertice nas coordenadas indicadas (base 0).
+ * @return ID do vertice ou -1.
+ */
+int version_find_vertex_id(const GraphVersion* version, int row, int col);
+
+/**
+ * @brief Obtem o vertice com o ID indicado.
+ * @return Vertice ou NULL se o ID for invalido ou estiver vazio.
+ */
+const Vertex* version_get_vertex(const GraphVersion* version, int id);
+
+/**
+ * @brief Obtem os vizinhos de um vertice.
+ * @return Numero de vizinhos; *neighbours aponta para os IDs (por ordem decrescente).
+ */
+int version_neighbours(const GraphVersion* version, int id, const int** neighbours);
+
+/**
+ * @brief DFS a partir da antena em (start_row, start_col) (base 1), como dfs_visit.
+ * @return Numero de antenas visitadas ou -1 se nao existir antena no inicio.
+ */
+int version_dfs_visit(const GraphVersion* version, int start_row, int start_col, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief BFS a partir da antena em (start_row, start_col) (base 1), como bfs_visit.
+ * @return Numero de antenas visitadas ou -1 se nao existir antena no inicio.
+ */
+int version_bfs_visit(const GraphVersion* version, int start_row, int start_col, VertexVisitor visitor, void* ctx);
+
+/**
+ * @brief Entrega ao visitor cada par (typeA, typeB) a distancia <= maxDistance, como
+ * find_intersections_visit. As origens seguem a ordem dos IDs e os destinos a ordem das coordenadas.
+ * @return Numero de intersecoes encontradas.
+ */
+int version_find_intersections_visit(const GraphVersion* version, char typeA, char typeB, int maxDistance,
+    IntersectionVisitor visitor, void* ctx);
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,258 @@
+/**
+ * @file ThreadHandler.c
+ * @brief Implementacao da camada de threads e operacoes atomicas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef _WIN32
+#define _DEFAULT_SOURCE
+#endif
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ThreadHandler.h"
+#include "Instrumentation.h"
+
+#pragma region Structs
+
+struct Thread {
+#ifdef _WIN32
+    HANDLE handle;        /**< Handle da thread */
+#else
+    pthread_t handle;     /**< Identificador da thread */
+#endif
+    ThreadFunction fn;    /**< Funcao a executar */
+    void* arg;            /**< Argumento da funcao */
+};
+
+#pragma endregion
+
+#pragma region Threads
+
+/**
+ * Funcao de entrada comum, que adapta a assinatura de cada sistema a ThreadFunction.
+ * No fim soma os contadores locais da thread aos totais da instrumentacao.
+ *
+ * \param arg - thread a executar
+ */
+#ifdef _WIN32
+static DWORD WINAPI thread_entry(LPVOID arg) {
+    Thread* thread = (Thread*)arg;
+    thread->fn(thread->arg);
+    INSTR_FLUSH();
+    return 0;
+}
+#else
+static void* thread_entry(void* arg) {
+    Thread* thread = (Thread*)arg;
+    thread->fn(thread->arg);
+    INSTR_FLUSH();
+    return NULL;
+}
+#endif
+
+/**
+ * Funcao para criar uma thread.
+ *
+ * \param fn - funcao a executar
+ * \param arg - argumento da funcao
+ * \return thread criada ou NULL
+ */
+Thread* thread_start(ThreadFunction fn, void* arg) {
+    Thread* thread = (Thread*)malloc(sizeof(Thread));
+    if (!thread) return NULL;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    thread->fn = fn;
+    thread->arg = arg;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    if (!thread->handle) {
+        free(thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, thread_entry, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+#endif
+    return thread;
+}
+
+/**
+ * Funcao para esperar pelo fim de uma thread e liberta-la.
+ *
+ * \param thread - thread criada por thread_start
+ */
+void thread_join(Thread* thread) {
+    if (!thread) return;
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+/**
+ * Funcao para obter o numero de processadores logicos.
+ *
+ * \return numero de processadores (pelo menos 1)
+ */
+int thread_hardware_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+#pragma endregion
+
+#pragma region Atomicos
+
+/**
+ * Funcao para somar um valor de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \param value - valor a somar
+ * \return valor anterior
+ */
+long thread_atomic_add(volatile long* target, long value) {
+#ifdef _WIN32
+    return InterlockedExchangeAdd(target, value);
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para ler um valor de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \return valor atual
+ */
+long thread_atomic_load(volatile long* target) {
+#ifdef _WIN32
+    return InterlockedCompareExchange(target, 0, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para escrever um valor de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \param value - novo valor
+ */
+void thread_atomic_store(volatile long* target, long value) {
+#ifdef _WIN32
+    InterlockedExchange(target, value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para somar um valor de 64 bits de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \param value - valor a somar
+ * \return valor anterior
+ */
+long long thread_atomic_add64(volatile long long* target, long long value) {
+#ifdef _WIN32
+    return InterlockedExchangeAdd64(target, value);
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para ler um valor de 64 bits de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \return valor atual
+ */
+long long thread_atomic_load64(volatile long long* target) {
+#ifdef _WIN32
+    return InterlockedCompareExchange64(target, 0, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para escrever um valor de 64 bits de forma atomica.
+ *
+ * \param target - valor partilhado
+ * \param value - novo valor
+ */
+void thread_atomic_store64(volatile long long* target, long long value) {
+#ifdef _WIN32
+    InterlockedExchange64(target, value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para trocar um valor se for igual ao esperado (compare-and-swap).
+ *
+ * \param target - valor partilhado
+ * \param expected - valor esperado
+ * \param desired - novo valor
+ * \return true se a troca foi feita
+ */
+bool thread_atomic_cas(volatile long* target, long expected, long desired) {
+#ifdef _WIN32
+    return InterlockedCompareExchange(target, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para ler um ponteiro de forma atomica.
+ *
+ * \param target - ponteiro partilhado
+ * \return ponteiro atual
+ */
+void* thread_atomic_load_ptr(void* volatile* target) {
+#ifdef _WIN32
+    return InterlockedCompareExchangePointer(target, NULL, NULL);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Funcao para escrever um ponteiro de forma atomica.
+ *
+ * \param target - ponteiro partilhado
+ * \param value - novo ponteiro
+ */
+void thread_atomic_store_ptr(void* volatile* target, void* value) {
+#ifdef _WIN32
+    InterlockedExchangePointer(target, value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+#pragma endregion
@@ -0,0 +1,100 @@
+/**
+ * @file ThreadHandler.h
+ * @brief Camada minima de threads e operacoes atomicas (Windows e POSIX).
+ *
+ * Em Windows usa CreateThread e as funcoes Interlocked; nos restantes sistemas usa
+ * pthreads e as operacoes __atomic do GCC/Clang. Todas as operacoes atomicas sao
+ * sequencialmente consistentes.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef THREAD_HANDLER_H
+#define THREAD_HANDLER_H
+
+#include <stdbool.h>
+
+#pragma region Structs
+
+/**
+ * @brief Funcao executada por uma thread.
+ */
+typedef void (*ThreadFunction)(void* arg);
+
+/**
+ * @struct Thread
+ * @brief Thread criada por thread_start (estrutura opaca).
+ */
+typedef struct Thread Thread;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Cria uma thread que executa fn(arg).
+ * @return Thread criada ou NULL em caso de erro.
+ */
+Thread* thread_start(ThreadFunction fn, void* arg);
+
+/**
+ * @brief Espera que a thread termine e liberta-a.
+ */
+void thread_join(Thread* thread);
+
+/**
+ * @brief Numero de processadores logicos disponiveis (pelo menos 1).
+ */
+int thread_hardware_count(void);
+
+/**
+ * @brief Soma value a *target de forma atomica.
+ * @return Valor de *target antes da soma.
+ */
+long thread_atomic_add(volatile long* target, long value);
+
+/**
+ * @brief Le *target de forma atomica.
+ */
+long thread_atomic_load(volatile long* target);
+
+/**
+ * @brief Escreve value em *target de forma atomica.
+ */
+void thread_atomic_store(volatile long* target, long value);
+
+/**
+ * @brief Soma value a um valor de 64 bits de forma atomica.
+ * @return Valor de *target antes da soma.
+ */
+long long thread_atomic_add64(volatile long long* target, long long value);
+
+/**
+ * @brief Le um valor de 64 bits de forma atomica.
+ */
+long long thread_atomic_load64(volatile long long* target);
+
+/**
+ * @brief Escreve um valor de 64 bits de forma atomica.
+ */
+void thread_atomic_store64(volatile long long* target, long long value);
+
+/**
+ * @brief Substitui *target por desired se for igual a expected.
+ * @return true se a troca foi feita.
+ */
+bool thread_atomic_cas(volatile long* target, long expected, long desired);
+
+/**
+ * @brief Le um ponteiro partilhado de forma atomica.
+ */
+void* thread_atomic_load_ptr(void* volatile* target);
+
+/**
+ * @brief Escreve um ponteiro partilhado de forma atomica.
+ */
+void thread_atomic_store_ptr(void* volatile* target, void* value);
+
+#pragma endregion
+
+#endif
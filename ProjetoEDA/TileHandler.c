@@ -0,0 +1,285 @@
+/**
+ * @file TileHandler.c
+ * @brief Implementacao do processamento de mapas por faixas de linhas.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "TileHandler.h"
+#include "Instrumentation.h"
+
+#pragma region Structs
+
+/**
+ * @struct TileRow
+ * @brief Linha do mapa mantida em memoria (buffer circular da janela).
+ */
+typedef struct TileRow {
+    char* cells;          /**< Conteudo da linha */
+    int* ids;             /**< ID de cada celula (-1 se vazia) */
+    int len;              /**< Numero de colunas da linha */
+    int capacity;         /**< Capacidade alocada de cells/ids */
+} TileRow;
+
+/**
+ * @struct TileWindow
+ * @brief Janela de linhas [first, loaded) em memoria, guardada num buffer circular.
+ */
+typedef struct TileWindow {
+    TileRow* rows;        /**< Buffer circular de linhas */
+    int capacity;         /**< Numero de linhas do buffer (bandRows + 2 * halo) */
+    int loaded;           /**< Numero de linhas ja lidas do ficheiro */
+    size_t bytes;         /**< Memoria atual ocupada pelas linhas */
+} TileWindow;
+
+#pragma endregion
+
+#pragma region Leitura de linhas
+
+/**
+ * Funcao para ler a proxima linha do ficheiro para uma posicao da janela.
+ * Se faltar memoria a linha fica com a capacidade anterior e nao conta como lida.
+ *
+ * \param file - ficheiro aberto
+ * \param window - janela de linhas
+ * \param nextId - proximo ID de antena (atualizado)
+ * \return 1 se a linha foi lida, 0 se nao existirem mais linhas ou -1 se faltar memoria
+ */
+static int load_row(FILE* file, TileWindow* window, int* nextId) {
+    TileRow* row = &window->rows[window->loaded % window->capacity];
+    int len = 0;
+    int ch;
+
+    while ((ch = getc(file)) != EOF && ch != '\n') {
+        if (len == row->capacity) {
+            int capacity = row->capacity ? row->capacity * 2 : 128;
+            char* cells = (char*)realloc(row->cells, capacity);
+            if (!cells) return -1;
+            row->cells = cells;
+            int* ids = (int*)realloc(row->ids, sizeof(int) * capacity);
+            if (!ids) return -1;
+            row->ids = ids;
+            window->bytes += (size_t)(capacity - row->capacity) * (sizeof(char) + sizeof(int));
+            row->capacity = capacity;
+            INSTR_COUNT(INSTR_ALLOCATIONS, 2);
+        }
+        row->cells[len] = (char)ch;
+        row->ids[len] = ch != '.' ? (*nextId)++ : -1;
+        len++;
+    }
+
+    if (ch == EOF && len == 0) return 0;
+    row->len = len;
+    window->loaded++;
+    return 1;
+}
+
+/**
+ * Funcao para obter uma linha da janela.
+ *
+ * \param window - janela de linhas
+ * \param row - indice global da linha
+ * \return ponteiro para a linha
+ */
+static const TileRow* window_row(const TileWindow* window, int row) {
+    return &window->rows[row % window->capacity];
+}
+
+/**
+ * Funcao para obter o conteudo de uma celula da janela ('.' fora da janela ou da linha).
+ *
+ * \param window - janela de linhas
+ * \param first - primeira linha valida da janela
+ * \param row - linha
+ * \param col - coluna
+ * \return caracter da celula
+ */
+static char window_cell(const TileWindow* window, int first, int row, int col) {
+    if (row < first || row >= window->loaded || col < 0) return '.';
+    const TileRow* r = window_row(window, row);
+    return col < r->len ? r->cells[col] : '.';
+}
+
+#pragma endregion
+
+#pragma region Processamento por faixas
+
+/**
+ * Funcao para preencher as opcoes por omissao.
+ *
+ * \param options - opcoes a preencher
+ */
+void tile_default_options(TileOptions* options) {
+    options->bandRows = 64;
+    options->radius = 4;
+    options->nefastoReach = 4;
+}
+
+/**
+ * Funcao para emitir as arestas de uma antena (vizinhos do mesmo tipo a distancia <= radius).
+ * Os destinos sao visitados por ordem crescente de ID.
+ */
+static long long emit_edges(const TileWindow* window, int first, int row, int col, int id, int radius,
+    const TileCallbacks* callbacks) {
+    char type = window_row(window, row)->cells[col];
+    long long count = 0;
+
+    for (int dr = -radius; dr <= radius; dr++) {
+        int r = row + dr;
+        if (r < first || r >= window->loaded) continue;
+        const TileRow* target = window_row(window, r);
+        int span = radius - abs(dr);
+        for (int c = col - span; c <= col + span; c++) {
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            if (c < 0 || c >= target->len || (dr == 0 && c == col)) continue;
+            if (target->cells[c] != type) continue;
+            if (callbacks && callbacks->on_edge) callbacks->on_edge(id, target->ids[c], callbacks->ctx);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Funcao para emitir os nefastos gerados por uma antena (pares do mesmo tipo ate reach linhas).
+ * Segue a regra de detect_nefasto: posicao = origem + (origem - par), se essa posicao estiver vazia.
+ */
+static long long emit_nefastos(const TileWindow* window, int first, int row, int col, int reach,
+    const TileCallbacks* callbacks) {
+    char type = window_row(window, row)->cells[col];
+    long long count = 0;
+    if (type == '#') return 0;
+
+    for (int dr = -reach; dr <= reach; dr++) {
+        int r = row + dr;
+        if (r < first || r >= window->loaded) continue;
+        const TileRow* pair = window_row(window, r);
+        for (int c = 0; c < pair->len; c++) {
+            if (pair->cells[c] != type || (dr == 0 && c == col)) continue;
+            INSTR_COUNT(INSTR_EDGES_EXAMINED, 1);
+            int nx = 2 * row - r;
+            int ny = 2 * col - c;
+            char existing = window_cell(window, first, nx, ny);
+            if (existing != '.' && existing != '#') continue;
+            if (callbacks && callbacks->on_nefasto) callbacks->on_nefasto(nx, ny, type, callbacks->ctx);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Funcao para processar um mapa por faixas.
+ *
+ * \param filename - nome do ficheiro
+ * \param options - parametros (NULL para os valores por omissao)
+ * \param callbacks - funcoes de resultado
+ * \param stats - totais da execucao
+ * \return true se o ficheiro foi processado
+ */
+bool process_map_tiled(const char* filename, const TileOptions* options,
+    const TileCallbacks* callbacks, TileStats* stats) {
+    TileOptions opts;
+    if (options) opts = *options;
+    else tile_default_options(&opts);
+    if (opts.bandRows <= 0) opts.bandRows = 1;
+    if (opts.radius < 0) opts.radius = 0;
+    if (opts.nefastoReach < 0) opts.nefastoReach = 0;
+
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        printf("Erro ao abrir ficheiro: %s\n", filename);
+        return false;
+    }
+
+    int halo = opts.radius > opts.nefastoReach ? opts.radius : opts.nefastoReach;
+    TileWindow window;
+    window.capacity = opts.bandRows + 2 * halo;
+    window.rows = (TileRow*)calloc(window.capacity, sizeof(TileRow));
+    window.loaded = 0;
+    window.bytes = sizeof(TileRow) * window.capacity;
+    INSTR_COUNT(INSTR_ALLOCATIONS, 1);
+    if (!window.rows) {
+        fclose(file);
+        return false;
+    }
+
+    TileStats local = { 0, 0, 0, 0, 0, 0, window.bytes };
+    int nextId = 0;
+    bool eof = false;
+    bool ok = true;
+
+    for (int bandStart = 0; ; bandStart += opts.bandRows) {
+        // A faixa precisa das linhas [bandStart - halo, bandStart + bandRows + halo)
+        INSTR_PHASE_BEGIN(PHASE_PARSE);
+        while (ok && !eof && window.loaded < bandStart + opts.bandRows + halo) {
+            int status = load_row(file, &window, &nextId);
+            ok = status != -1;
+            eof = status == 0;
+        }
+        if (window.bytes > local.peakBytes) local.peakBytes = window.bytes;
+        if (!ok || bandStart >= window.loaded) {
+            INSTR_PHASE_END(PHASE_PARSE);
+            break;
+        }
+
+        int bandEnd = bandStart + opts.bandRows < window.loaded ? bandStart + opts.bandRows : window.loaded;
+        int first = bandStart - halo > 0 ? bandStart - halo : 0;
+
+        for (int row = bandStart; row < bandEnd; row++) {
+            const TileRow* r = window_row(&window, row);
+            if (r->len > local.cols) local.cols = r->len;
+            for (int col = 0; col < r->len; col++) {
+                if (r->ids[col] == -1) continue;
+                local.antennas++;
+                if (callbacks && callbacks->on_antenna)
+                    callbacks->on_antenna(r->ids[col], row, col, r->cells[col], callbacks->ctx);
+            }
+        }
+        INSTR_PHASE_END(PHASE_PARSE);
+
+        // Arestas e nefastos em passagens separadas, com o tempo nas mesmas fases de read_graph_from_file
+        // e detect_nefasto
+        if (opts.radius > 0) {
+            INSTR_PHASE_BEGIN(PHASE_EDGES);
+            for (int row = bandStart; row < bandEnd; row++) {
+                const TileRow* r = window_row(&window, row);
+                for (int col = 0; col < r->len; col++)
+                    if (r->ids[col] != -1)
+                        local.edges += emit_edges(&window, first, row, col, r->ids[col], opts.radius, callbacks);
+            }
+            INSTR_PHASE_END(PHASE_EDGES);
+        }
+        if (opts.nefastoReach > 0) {
+            INSTR_PHASE_BEGIN(PHASE_NEFASTO);
+            for (int row = bandStart; row < bandEnd; row++) {
+                const TileRow* r = window_row(&window, row);
+                for (int col = 0; col < r->len; col++)
+                    if (r->ids[col] != -1)
+                        local.nefastos += emit_nefastos(&window, first, row, col, opts.nefastoReach, callbacks);
+            }
+            INSTR_PHASE_END(PHASE_NEFASTO);
+        }
+        local.tiles++;
+    }
+    local.rows = window.loaded;
+    fclose(file);
+
+    for (int i = 0; i < window.capacity; i++) {
+        free(window.rows[i].cells);
+        free(window.rows[i].ids);
+    }
+    free(window.rows);
+
+    if (!ok) return false;
+    if (stats) *stats = local;
+    return true;
+}
+
+#pragma endregion
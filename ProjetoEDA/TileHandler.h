@@ -0,0 +1,90 @@
+/**
+ * @file TileHandler.h
+ * @brief Processamento de mapas por faixas de linhas (tiles), sem carregar o mapa inteiro.
+ *
+ * O ficheiro e lido em streaming. Cada faixa de bandRows linhas e processada com
+ * uma margem (halo) de linhas vizinhas acima e abaixo, com largura igual ao maior
+ * entre o raio de ligacao e o alcance dos nefastos. Cada antena pertence a faixa
+ * da sua linha, por isso arestas e nefastos que cruzam a fronteira entre faixas
+ * sao emitidos uma unica vez, pela faixa da antena de origem.
+ *
+ * A memoria usada e proporcional a (bandRows + 2 * halo) linhas, e nao ao mapa.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#ifndef TILE_HANDLER_H
+#define TILE_HANDLER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#pragma region Structs
+
+/**
+ * @struct TileOptions
+ * @brief Parametros do processamento por faixas.
+ */
+typedef struct TileOptions {
+    int bandRows;         /**< Linhas por faixa (> 0) */
+    int radius;           /**< Distancia de Manhattan maxima das arestas (0 desliga as arestas) */
+    int nefastoReach;     /**< Distancia maxima em linhas entre as duas antenas de um par nefasto
+                               (0 desliga os nefastos; >= numero de linhas reproduz detect_nefasto) */
+} TileOptions;
+
+/**
+ * @struct TileCallbacks
+ * @brief Funcoes chamadas com os resultados. Qualquer uma pode ser NULL.
+ *
+ * Os IDs seguem a mesma numeracao de read_graph_from_file (ordem de leitura).
+ * As coordenadas sao de base 0, como em Node e Vertex. Em cada faixa sao emitidas
+ * primeiro as antenas, depois as arestas e por fim os nefastos.
+ */
+typedef struct TileCallbacks {
+    void (*on_antenna)(int id, int row, int col, char type, void* ctx);  /**< Antena lida */
+    void (*on_edge)(int sourceId, int destId, void* ctx);                 /**< Aresta sourceId -> destId */
+    void (*on_nefasto)(int row, int col, char type, void* ctx);           /**< Nefasto gerado por um par do tipo indicado */
+    void* ctx;                                                            /**< Contexto passado as funcoes */
+} TileCallbacks;
+
+/**
+ * @struct TileStats
+ * @brief Totais de uma execucao por faixas.
+ */
+typedef struct TileStats {
+    int rows, cols;       /**< Dimensoes do mapa */
+    int antennas;         /**< Numero de antenas */
+    long long edges;      /**< Numero de arestas emitidas */
+    long long nefastos;   /**< Numero de nefastos emitidos */
+    int tiles;            /**< Numero de faixas processadas */
+    size_t peakBytes;     /**< Memoria maxima usada pelas linhas em memoria */
+} TileStats;
+
+#pragma endregion
+
+#pragma region Funcoes
+/**
+ * @brief Preenche as opcoes por omissao (64 linhas por faixa, raio 4, alcance dos nefastos 4).
+ */
+void tile_default_options(TileOptions* options);
+
+/**
+ * @brief Processa um mapa por faixas, emitindo antenas, arestas e nefastos pelos callbacks.
+ *
+ * As arestas sao as mesmas de read_graph_from_file quando radius = 4. Os nefastos sao os
+ * de detect_nefasto (um por par ordenado, pela mesma ordem) limitados aos pares cuja
+ * diferenca de linhas nao excede nefastoReach.
+ *
+ * @param filename Nome do ficheiro do mapa.
+ * @param options Parametros (NULL usa os valores por omissao).
+ * @param callbacks Funcoes de resultado (pode ser NULL).
+ * @param stats Totais da execucao (pode ser NULL).
+ * @return true se o ficheiro foi processado; false se nao abrir ou faltar memoria (stats nao e alterado).
+ */
+bool process_map_tiled(const char* filename, const TileOptions* options,
+    const TileCallbacks* callbacks, TileStats* stats);
+
+#pragma endregion
+
+#endif
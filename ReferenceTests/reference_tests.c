@@ -0,0 +1,1172 @@
+/**
+ * @file reference_tests.c
+ * @brief Testes diferenciais das implementacoes otimizadas contra as funcoes originais.
+ *
+ * As funcoes originais sao o oraculo: detect_nefasto para os nefastos e o texto que
+ * dfs, bfs, find_all_paths e find_intersections escrevem no stdout (capturado para um
+ * ficheiro temporario). As verificacoes que nao produzem texto comparam com as funcoes
+ * _visit sobre as quais as originais imprimem. Corre sobre os ficheiros Mapa*.txt e sobre
+ * mapas gerados pelo MapGenerator. Verificacoes por mapa:
+ *   - read_matrix_parallel e AntennaStore contra read_matrix_from_file
+ *   - nefastos e arestas de process_map_tiled contra detect_nefasto e read_graph_from_file
+ *   - run_queries (1 e varias threads) e grafos lazy contra dfs/bfs/find_all_paths/find_intersections
+ *   - SnapshotHandler, multi_source_bfs e find_path_stats contra dfs_visit/bfs_visit/find_all_paths_visit
+ *   - apply_map_delta (lista, grafo, grafo lazy) e versoes editadas contra a leitura da nova revisao
+ *
+ * Uso: ReferenceTests [--data pasta] [--maps N] [--seed S] [--threads N]
+ *                     [--nefasto-max-antennas N] [--map ficheiro] [--revision ficheiro]
+ *
+ * Escreve uma linha por verificacao falhada e um resumo; o codigo de saida e 1 se alguma falhar.
+ *
+ * @author Maksym Yavorenko
+ * @date June 2025
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#ifndef _WIN32
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define close _close
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+#include "ListHandler.h"
+#include "GraphHandler.h"
+#include "MapGenerator.h"
+#include "TileHandler.h"
+#include "AntennaStore.h"
+#include "ConcurrentStore.h"
+#include "QueryHandler.h"
+#include "SnapshotHandler.h"
+#include "DiffHandler.h"
+
+#define MAX_TRAVERSAL_STARTS 40   /* Antenas de inicio de DFS/BFS por mapa */
+#define MAX_PATH_PAIRS 12         /* Pares de antenas para find_all_paths por mapa */
+#define PATHS_MAX_COMPONENT 9     /* Tamanho maximo das componentes usadas em find_all_paths */
+#define MAX_QUERY_TYPES 4         /* Tipos combinados nas consultas de intersecoes */
+#define MAX_SOURCES 4             /* Origens de multi_source_bfs */
+#define MAP_MUTATIONS 12          /* Celulas alteradas na revisao usada em apply_map_delta */
+
+#pragma region Structs
+
+/**
+ * @struct TestConfig
+ * @brief Configuracao de uma execucao dos testes.
+ */
+typedef struct TestConfig {
+    const char* dataDir;        /**< Pasta dos ficheiros Mapa*.txt */
+    int numMaps;                /**< Numero de mapas gerados */
+    unsigned int seed;          /**< Semente do primeiro mapa gerado */
+    int threads;                /**< Threads de run_queries e read_matrix_parallel */
+    int nefastoMaxAntennas;     /**< Acima deste numero de antenas os nefastos nao sao comparados */
+    const char* mapFile;        /**< Ficheiro temporario dos mapas gerados */
+    const char* revisionFile;   /**< Ficheiro temporario da revisao usada em apply_map_delta */
+} TestConfig;
+
+/**
+ * @struct IntArray
+ * @brief Vetor dinamico de inteiros onde os resultados a comparar sao registados.
+ */
+typedef struct IntArray {
+    int* items;           /**< Valores */
+    int count;            /**< Numero de valores */
+    int capacity;         /**< Capacidade de items */
+} IntArray;
+
+/**
+ * @struct Capture
+ * @brief Redirecionamento do stdout para um ficheiro temporario.
+ */
+typedef struct Capture {
+    FILE* file;           /**< Ficheiro que recebe o stdout */
+    int saved;            /**< Descritor original do stdout */
+} Capture;
+
+/**
+ * @struct PathTally
+ * @brief Contagem dos caminhos entregues por find_all_paths_visit.
+ */
+typedef struct PathTally {
+    long long count;      /**< Caminhos com no maximo maxHops saltos */
+    int shortest;         /**< Saltos do mais curto (-1 se nenhum) */
+    int longest;          /**< Saltos do mais longo (-1 se nenhum) */
+    int maxHops;          /**< Limite de saltos (< 0 sem limite) */
+} PathTally;
+
+/**
+ * @struct SnapshotEdit
+ * @brief Rascunho que recebe os eventos de diff_map_files.
+ */
+typedef struct SnapshotEdit {
+    VersionedGraph* vgraph;   /**< Grafo com versoes */
+    GraphVersion* draft;      /**< Rascunho a editar */
+    bool ok;                  /**< false se algum evento nao pode ser aplicado */
+} SnapshotEdit;
+
+#pragma endregion
+
+#pragma region Resultados
+
+static int checksRun = 0;
+static int checksFailed = 0;
+
+/**
+ * Funcao para registar o resultado de uma verificacao.
+ *
+ * \param ok - resultado
+ * \param label - mapa verificado
+ * \param what - descricao da verificacao
+ */
+static void check(bool ok, const char* label, const char* what) {
+    checksRun++;
+    if (ok) return;
+    checksFailed++;
+    printf("FALHOU [%s] %s\n", label, what);
+}
+
+/**
+ * Funcao para acrescentar um valor a um IntArray.
+ *
+ * \param array - vetor
+ * \param value - valor
+ */
+static void push(IntArray* array, int value) {
+    if (array->count == array->capacity) {
+        int capacity = array->capacity ? array->capacity * 2 : 64;
+        int* items = (int*)realloc(array->items, sizeof(int) * capacity);
+        if (!items) {
+            fprintf(stderr, "Memoria insuficiente\n");
+            exit(1);
+        }
+        array->items = items;
+        array->capacity = capacity;
+    }
+    array->items[array->count++] = value;
+}
+
+/**
+ * Funcao para comparar dois IntArray.
+ *
+ * \return true se tem os mesmos valores pela mesma ordem
+ */
+static bool same_array(const IntArray* a, const IntArray* b) {
+    return a->count == b->count && (a->count == 0 || memcmp(a->items, b->items, sizeof(int) * a->count) == 0);
+}
+
+/**
+ * Funcao para esvaziar um IntArray e libertar a memoria.
+ *
+ * \param array - vetor
+ */
+static void clear_array(IntArray* array) {
+    free(array->items);
+    array->items = NULL;
+    array->count = 0;
+    array->capacity = 0;
+}
+
+/**
+ * Funcao para comparar lexicograficamente dois grupos de n inteiros.
+ */
+static int compare_ints(const int* x, const int* y, int n) {
+    for (int i = 0; i < n; i++)
+        if (x[i] != y[i]) return x[i] < y[i] ? -1 : 1;
+    return 0;
+}
+
+/**
+ * Funcoes de comparacao para ordenar pares e quadruplos de inteiros com qsort.
+ */
+static int compare_int2(const void* a, const void* b) {
+    return compare_ints((const int*)a, (const int*)b, 2);
+}
+
+static int compare_int4(const void* a, const void* b) {
+    return compare_ints((const int*)a, (const int*)b, 4);
+}
+
+/**
+ * Funcao para comparar duas listas de antenas.
+ *
+ * \return true se tem as mesmas antenas pela mesma ordem
+ */
+static bool same_list(const Node* a, const Node* b) {
+    for (; a != NULL && b != NULL; a = a->next, b = b->next)
+        if (a->x != b->x || a->y != b->y || a->type != b->type) return false;
+    return a == NULL && b == NULL;
+}
+
+/**
+ * Funcao para obter as coordenadas dos nos '#' de uma lista, ordenadas.
+ */
+static void nefasto_positions(const Node* list, IntArray* out) {
+    for (; list != NULL; list = list->next) {
+        if (list->type != '#') continue;
+        push(out, list->x);
+        push(out, list->y);
+    }
+    if (out->count > 0) qsort(out->items, out->count / 2, sizeof(int) * 2, compare_int2);
+}
+
+/**
+ * Funcao para comparar duas listas com nefastos.
+ *
+ * \return true se tem as mesmas antenas pela mesma ordem e os mesmos nefastos (em qualquer ordem)
+ */
+static bool same_list_with_nefastos(const Node* a, const Node* b) {
+    const Node* x = a;
+    const Node* y = b;
+    for (;;) {
+        while (x != NULL && x->type == '#') x = x->next;
+        while (y != NULL && y->type == '#') y = y->next;
+        if (x == NULL || y == NULL) break;
+        if (x->x != y->x || x->y != y->y || x->type != y->type) return false;
+        x = x->next;
+        y = y->next;
+    }
+    if (x != NULL || y != NULL) return false;
+
+    IntArray first = { NULL, 0, 0 }, second = { NULL, 0, 0 };
+    nefasto_positions(a, &first);
+    nefasto_positions(b, &second);
+    bool same = same_array(&first, &second);
+    clear_array(&first);
+    clear_array(&second);
+    return same;
+}
+
+#pragma endregion
+
+#pragma region Captura do stdout
+
+/**
+ * Funcao para ler todo o conteudo de um ficheiro temporario e fecha-lo.
+ * Os '\r' sao ignorados para o texto do stdout em modo texto poder ser comparado.
+ *
+ * \param file - ficheiro aberto
+ * \return texto (libertar com free) ou NULL
+ */
+static char* read_text(FILE* file) {
+    fflush(file);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+
+    char* text = size >= 0 ? (char*)malloc((size_t)size + 1) : NULL;
+    if (text) {
+        long length = 0;
+        int ch;
+        while ((ch = getc(file)) != EOF && length < size)
+            if (ch != '\r') text[length++] = (char)ch;
+        text[length] = '\0';
+    }
+    fclose(file);
+    return text;
+}
+
+/**
+ * Funcao para comecar a capturar o stdout.
+ *
+ * \param capture - estado da captura
+ * \return false se nao foi possivel redirecionar o stdout
+ */
+static bool capture_begin(Capture* capture) {
+    fflush(stdout);
+    capture->file = tmpfile();
+    if (!capture->file) return false;
+
+    capture->saved = dup(fileno(stdout));
+    if (capture->saved == -1 || dup2(fileno(capture->file), fileno(stdout)) == -1) {
+        if (capture->saved != -1) close(capture->saved);
+        fclose(capture->file);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Funcao para terminar a captura e repor o stdout.
+ *
+ * \param capture - estado da captura
+ * \return texto capturado (libertar com free) ou NULL
+ */
+static char* capture_end(Capture* capture) {
+    fflush(stdout);
+    dup2(capture->saved, fileno(stdout));
+    close(capture->saved);
+    return read_text(capture->file);
+}
+
+/**
+ * Funcao para comparar dois textos, falhando se algum nao foi obtido.
+ */
+static bool same_text(const char* a, const char* b) {
+    return a != NULL && b != NULL && strcmp(a, b) == 0;
+}
+
+#pragma endregion
+
+#pragma region Visitors
+
+/**
+ * Funcao para registar o ID e a profundidade de cada vertice visitado.
+ */
+static void log_vertex(const Vertex* vertex, int depth, void* ctx) {
+    push((IntArray*)ctx, vertex->id);
+    push((IntArray*)ctx, depth);
+}
+
+/**
+ * Funcao para registar cada intersecao.
+ */
+static void log_intersection(const Vertex* source, const Vertex* target, int distance, void* ctx) {
+    push((IntArray*)ctx, source->id);
+    push((IntArray*)ctx, target->id);
+    push((IntArray*)ctx, distance);
+}
+
+/**
+ * Funcao para guardar a distancia BFS de cada vertice visitado.
+ */
+static void record_depth(const Vertex* vertex, int depth, void* ctx) {
+    ((int*)ctx)[vertex->id] = depth;
+}
+
+/**
+ * Funcao para contar um caminho entregue por find_all_paths_visit.
+ */
+static void tally_path(const Graph* graph, const int* path, int pathLen, void* ctx) {
+    PathTally* tally = (PathTally*)ctx;
+    int hops = pathLen - 1;
+    (void)graph;
+    (void)path;
+    if (tally->maxHops >= 0 && hops > tally->maxHops) return;
+    tally->count++;
+    if (tally->shortest == -1 || hops < tally->shortest) tally->shortest = hops;
+    if (hops > tally->longest) tally->longest = hops;
+}
+
+/**
+ * Funcoes de registo dos resultados de process_map_tiled.
+ */
+static void log_tile_antenna(int id, int row, int col, char type, void* ctx) {
+    IntArray* antennas = ((IntArray**)ctx)[0];
+    push(antennas, id);
+    push(antennas, row);
+    push(antennas, col);
+    push(antennas, type);
+}
+
+static void log_tile_edge(int sourceId, int destId, void* ctx) {
+    IntArray* edges = ((IntArray**)ctx)[1];
+    push(edges, sourceId);
+    push(edges, destId);
+}
+
+static void log_tile_nefasto(int row, int col, char type, void* ctx) {
+    IntArray* nefastos = ((IntArray**)ctx)[2];
+    (void)type;
+    push(nefastos, row);
+    push(nefastos, col);
+}
+
+/**
+ * Funcao para aplicar um evento de diff_map_files a um rascunho de versao.
+ */
+static void apply_snapshot_event(const MapEvent* event, void* ctx) {
+    SnapshotEdit* edit = (SnapshotEdit*)ctx;
+    int id = event->kind == MAP_EVENT_INSERT
+        ? version_insert_antenna(edit->vgraph, edit->draft, event->row, event->col, event->type)
+        : version_delete_antenna(edit->vgraph, edit->draft, event->row, event->col);
+    if (id == -1) edit->ok = false;
+}
+
+#pragma endregion
+
+#pragma region Consultas
+
+/**
+ * Funcao para acrescentar uma consulta ao vetor.
+ */
+static void add_query(Query* queries, int* count, QueryKind kind, int row, int col, int endRow, int endCol) {
+    Query* query = &queries[(*count)++];
+    memset(query, 0, sizeof(Query));
+    query->kind = kind;
+    query->row = row;
+    query->col = col;
+    query->endRow = endRow;
+    query->endCol = endCol;
+    query->maxHops = -1;
+}
+
+/**
+ * Funcao para criar as consultas de um mapa: DFS e BFS a partir de antenas espalhadas pelo
+ * mapa e de uma posicao vazia, caminhos entre antenas de componentes pequenas (a enumeracao
+ * e exponencial) e intersecoes entre os primeiros tipos do mapa.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param count - numero de consultas criadas
+ * \return vetor de consultas (libertar com free)
+ */
+static Query* build_queries(Graph* graph, int* count) {
+    int capacity = 2 * (MAX_TRAVERSAL_STARTS + 2) + MAX_PATH_PAIRS + 3 * MAX_QUERY_TYPES * MAX_QUERY_TYPES;
+    Query* queries = (Query*)malloc(sizeof(Query) * capacity);
+    int n = graph->numVertices;
+    *count = 0;
+    if (!queries) return NULL;
+
+    int step = n / MAX_TRAVERSAL_STARTS + 1;
+    for (int id = 0; id < n; id += step) {
+        Vertex* v = get_vertex(graph, id);
+        add_query(queries, count, QUERY_DFS, v->row + 1, v->col + 1, 0, 0);
+        add_query(queries, count, QUERY_BFS, v->row + 1, v->col + 1, 0, 0);
+    }
+    add_query(queries, count, QUERY_DFS, 0, 0, 0, 0);
+    add_query(queries, count, QUERY_BFS, 0, 0, 0, 0);
+
+    int* ids = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+    bool* seen = (bool*)calloc(n > 0 ? n : 1, sizeof(bool));
+    int pairs = 0;
+    for (int id = 0; id < n && pairs < MAX_PATH_PAIRS && ids && seen; id++) {
+        if (seen[id]) continue;
+        Vertex* v = get_vertex(graph, id);
+        int size = dfs_collect(graph, v->row + 1, v->col + 1, ids, n);
+        for (int i = 0; i < size; i++) seen[ids[i]] = true;
+        if (size < 2 || size > PATHS_MAX_COMPONENT) continue;
+        Vertex* end = get_vertex(graph, ids[size - 1]);
+        add_query(queries, count, QUERY_PATHS, v->row + 1, v->col + 1, end->row + 1, end->col + 1);
+        pairs++;
+    }
+    free(ids);
+    free(seen);
+
+    char types[MAX_QUERY_TYPES];
+    int numTypes = 0;
+    for (Vertex* v = graph->vertices; v != NULL && numTypes < MAX_QUERY_TYPES; v = v->next)
+        if (!memchr(types, v->type, numTypes)) types[numTypes++] = v->type;
+
+    static const int distances[] = { 0, 3, 8 };
+    for (int a = 0; a < numTypes; a++) {
+        for (int b = 0; b < numTypes; b++) {
+            if (a == b) continue;
+            for (int d = 0; d < 3; d++) {
+                add_query(queries, count, QUERY_INTERSECTIONS, 0, 0, 0, 0);
+                queries[*count - 1].typeA = types[a];
+                queries[*count - 1].typeB = types[b];
+                queries[*count - 1].maxDistance = distances[d];
+            }
+        }
+    }
+    return queries;
+}
+
+/**
+ * Funcao para executar as consultas com as funcoes originais e capturar o texto escrito.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param queries - consultas
+ * \param count - numero de consultas
+ * \return texto (libertar com free) ou NULL
+ */
+static char* oracle_text(Graph* graph, const Query* queries, int count) {
+    Capture capture;
+    if (!capture_begin(&capture)) return NULL;
+
+    for (int i = 0; i < count; i++) {
+        const Query* q = &queries[i];
+        switch (q->kind) {
+        case QUERY_DFS: dfs(graph, q->row, q->col); break;
+        case QUERY_BFS: bfs(graph, q->row, q->col); break;
+        case QUERY_PATHS: find_all_paths(graph, q->row, q->col, q->endRow, q->endCol); break;
+        case QUERY_INTERSECTIONS: find_intersections(graph, q->typeA, q->typeB, q->maxDistance); break;
+        default: break;
+        }
+    }
+    return capture_end(&capture);
+}
+
+/**
+ * Funcao para executar as consultas com run_queries e obter o texto escrito.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param queries - consultas
+ * \param count - numero de consultas
+ * \param threads - numero de threads
+ * \return texto (libertar com free) ou NULL
+ */
+static char* batch_text(Graph* graph, const Query* queries, int count, int threads) {
+    FILE* out = tmpfile();
+    if (!out) return NULL;
+    if (run_queries(graph, queries, count, threads, out) != count) {
+        fclose(out);
+        return NULL;
+    }
+    return read_text(out);
+}
+
+#pragma endregion
+
+#pragma region Verificacoes
+
+/**
+ * Funcao para comparar os leitores rapidos com read_matrix_from_file.
+ *
+ * \param config - configuracao dos testes
+ * \param filename - ficheiro do mapa
+ * \param label - nome do mapa nas mensagens
+ */
+static void check_readers(const TestConfig* config, const char* filename, const char* label) {
+    Node* expected = NULL;
+    int rows, cols, r, c;
+    read_matrix_from_file(filename, &expected, &rows, &cols);
+
+    const int threads[] = { 1, 2, config->threads };
+    for (int i = 0; i < 3; i++) {
+        Node* list = NULL;
+        bool ok = read_matrix_parallel(filename, &list, &r, &c, threads[i]);
+        char what[64];
+        snprintf(what, sizeof(what), "read_matrix_parallel (%d threads)", threads[i]);
+        check(ok && r == rows && c == cols && same_list(expected, list), label, what);
+        deallocate(&list);
+    }
+
+    AntennaStore* store = read_store_from_file(filename, &r, &c);
+    Node* list = store ? store_to_list(store) : NULL;
+    check(store && r == rows && c == cols && same_list(expected, list), label, "read_store_from_file");
+    deallocate(&list);
+    store_free(store);
+    deallocate(&expected);
+}
+
+/**
+ * Funcao para comparar process_map_tiled com detect_nefasto e com read_graph_from_file.
+ *
+ * \param filename - ficheiro do mapa
+ * \param label - nome do mapa nas mensagens
+ * \param graph - grafo lido do ficheiro
+ * \param nefastos - true para comparar tambem os nefastos
+ */
+static void check_tiled(const char* filename, const char* label, Graph* graph, bool nefastos) {
+    Node* list = NULL;
+    int rows, cols;
+    read_matrix_from_file(filename, &list, &rows, &cols);
+    IntArray expectedNefastos = { NULL, 0, 0 };
+    if (nefastos) {
+        detect_nefasto(&list);
+        for (Node* curr = list; curr != NULL; curr = curr->next) {
+            if (curr->type != '#') continue;
+            push(&expectedNefastos, curr->x);
+            push(&expectedNefastos, curr->y);
+        }
+    }
+    deallocate(&list);
+
+    IntArray expectedAntennas = { NULL, 0, 0 }, expectedEdges = { NULL, 0, 0 };
+    for (int id = 0; id < graph->numVertices; id++) {
+        Vertex* v = get_vertex(graph, id);
+        push(&expectedAntennas, id);
+        push(&expectedAntennas, v->row);
+        push(&expectedAntennas, v->col);
+        push(&expectedAntennas, v->type);
+        for (Edge* e = get_neighbours(graph, id); e != NULL; e = e->next) {
+            push(&expectedEdges, id);
+            push(&expectedEdges, e->destId);
+        }
+    }
+    qsort(expectedEdges.items, expectedEdges.count / 2, sizeof(int) * 2, compare_int2);
+
+    // Faixas de 3 linhas obrigam a usar as margens; 64 linhas cobrem os mapas pequenos de uma vez
+    const int bands[] = { 3, 64 };
+    for (int i = 0; i < 2; i++) {
+        IntArray antennas = { NULL, 0, 0 }, edges = { NULL, 0, 0 }, found = { NULL, 0, 0 };
+        IntArray* logs[3] = { &antennas, &edges, &found };
+        TileOptions options;
+        tile_default_options(&options);
+        options.bandRows = bands[i];
+        options.radius = GRAPH_RADIUS;
+        options.nefastoReach = nefastos ? rows + 1 : 0;
+        TileCallbacks callbacks = { log_tile_antenna, log_tile_edge, log_tile_nefasto, logs };
+
+        bool ok = process_map_tiled(filename, &options, &callbacks, NULL);
+        qsort(edges.items, edges.count / 2, sizeof(int) * 2, compare_int2);
+        char what[96];
+        snprintf(what, sizeof(what), "process_map_tiled (%d linhas) vs read_graph_from_file", bands[i]);
+        check(ok && same_array(&antennas, &expectedAntennas) && same_array(&edges, &expectedEdges), label, what);
+        if (nefastos) {
+            snprintf(what, sizeof(what), "process_map_tiled (%d linhas) vs detect_nefasto", bands[i]);
+            check(ok && same_array(&found, &expectedNefastos), label, what);
+        }
+        clear_array(&antennas);
+        clear_array(&edges);
+        clear_array(&found);
+    }
+    clear_array(&expectedNefastos);
+    clear_array(&expectedAntennas);
+    clear_array(&expectedEdges);
+}
+
+/**
+ * Funcao para comparar run_queries e o grafo lazy com as funcoes originais.
+ *
+ * \param config - configuracao dos testes
+ * \param filename - ficheiro do mapa
+ * \param label - nome do mapa nas mensagens
+ * \param graph - grafo lido do ficheiro
+ * \param queries - consultas
+ * \param count - numero de consultas
+ */
+static void check_queries(const TestConfig* config, const char* filename, const char* label,
+    Graph* graph, const Query* queries, int count) {
+    char* expected = oracle_text(graph, queries, count);
+    check(expected != NULL, label, "captura do stdout");
+    if (!expected) return;
+
+    char* text = batch_text(graph, queries, count, 1);
+    check(same_text(expected, text), label, "run_queries (1 thread) vs dfs/bfs/find_all_paths/find_intersections");
+    free(text);
+
+    text = batch_text(graph, queries, count, config->threads);
+    check(same_text(expected, text), label, "run_queries (varias threads) vs dfs/bfs/find_all_paths/find_intersections");
+    free(text);
+
+    int rows, cols;
+    Graph* lazy = read_graph_lazy(filename, &rows, &cols);
+    text = lazy ? oracle_text(lazy, queries, count) : NULL;
+    check(same_text(expected, text), label, "read_graph_lazy vs read_graph_from_file");
+    free(text);
+    free_graph(lazy);
+
+    lazy = read_graph_lazy(filename, &rows, &cols);
+    text = lazy ? batch_text(lazy, queries, count, config->threads) : NULL;
+    check(same_text(expected, text), label, "run_queries sobre grafo lazy vs dfs/bfs/find_all_paths/find_intersections");
+    free(text);
+    free_graph(lazy);
+    free(expected);
+}
+
+/**
+ * Funcao para comparar as consultas sobre a versao 0 de um VersionedGraph com as do grafo.
+ *
+ * \param label - nome do mapa nas mensagens
+ * \param graph - grafo lido do ficheiro
+ * \param queries - consultas
+ * \param count - numero de consultas
+ */
+static void check_snapshot(const char* label, Graph* graph, const Query* queries, int count) {
+    VersionedGraph* vgraph = versioned_graph_create(graph);
+    int slot = vgraph ? snapshot_register_reader(vgraph) : -1;
+    check(slot != -1, label, "versioned_graph_create");
+    if (slot == -1) {
+        if (vgraph) versioned_graph_free(vgraph);
+        return;
+    }
+
+    const GraphVersion* version = snapshot_pin(vgraph, slot);
+    bool same = true;
+    for (int i = 0; i < count && same; i++) {
+        const Query* q = &queries[i];
+        IntArray a = { NULL, 0, 0 }, b = { NULL, 0, 0 };
+        if (q->kind == QUERY_DFS)
+            same = dfs_visit(graph, q->row, q->col, log_vertex, &a) == version_dfs_visit(version, q->row, q->col, log_vertex, &b);
+        else if (q->kind == QUERY_BFS)
+            same = bfs_visit(graph, q->row, q->col, log_vertex, &a) == version_bfs_visit(version, q->row, q->col, log_vertex, &b);
+        else if (q->kind == QUERY_INTERSECTIONS)
+            same = find_intersections_visit(graph, q->typeA, q->typeB, q->maxDistance, log_intersection, &a)
+                == version_find_intersections_visit(version, q->typeA, q->typeB, q->maxDistance, log_intersection, &b);
+        same = same && same_array(&a, &b);
+        clear_array(&a);
+        clear_array(&b);
+    }
+    check(same, label, "SnapshotHandler (versao 0) vs dfs_visit/bfs_visit/find_intersections_visit");
+
+    snapshot_unpin(vgraph, slot);
+    snapshot_unregister_reader(vgraph, slot);
+    versioned_graph_free(vgraph);
+}
+
+/**
+ * Funcao para comparar multi_source_bfs com uma bfs_visit por origem.
+ * A distancia esperada e a menor das BFS e a origem mais proxima a primeira que a atinge.
+ *
+ * \param label - nome do mapa nas mensagens
+ * \param graph - grafo lido do ficheiro
+ * \param queries - consultas (as origens sao os inicios das DFS)
+ * \param count - numero de consultas
+ */
+static void check_multi_source(const char* label, Graph* graph, const Query* queries, int count) {
+    int n = graph->numVertices;
+    int sources[MAX_SOURCES];
+    int numSources = 0;
+    for (int i = 0; i < count && numSources < MAX_SOURCES; i++) {
+        if (queries[i].kind != QUERY_DFS) continue;
+        int id = find_vertex_id(graph, queries[i].row - 1, queries[i].col - 1);
+        if (id != -1) sources[numSources++] = id;
+    }
+    if (numSources == 0) return;
+
+    int* single = (int*)malloc(sizeof(int) * n * numSources);
+    int* dist = (int*)malloc(sizeof(int) * n);
+    int* nearest = (int*)malloc(sizeof(int) * n);
+    bool same = single && dist && nearest;
+
+    for (int s = 0; s < numSources && same; s++) {
+        int* expected = single + (long long)s * n;
+        for (int id = 0; id < n; id++) expected[id] = -1;
+        Vertex* v = get_vertex(graph, sources[s]);
+        bfs_visit(graph, v->row + 1, v->col + 1, record_depth, expected);
+
+        multi_source_bfs(graph, &sources[s], 1, dist, nearest);
+        for (int id = 0; id < n && same; id++)
+            same = dist[id] == expected[id] && nearest[id] == (expected[id] == -1 ? -1 : sources[s]);
+    }
+
+    if (same) {
+        multi_source_bfs(graph, sources, numSources, dist, nearest);
+        for (int id = 0; id < n && same; id++) {
+            int best = -1, bestSource = -1;
+            for (int s = 0; s < numSources; s++) {
+                int d = single[(long long)s * n + id];
+                if (d != -1 && (best == -1 || d < best)) {
+                    best = d;
+                    bestSource = sources[s];
+                }
+            }
+            same = dist[id] == best && nearest[id] == bestSource;
+        }
+    }
+    check(same, label, "multi_source_bfs vs bfs_visit");
+
+    free(single);
+    free(dist);
+    free(nearest);
+}
+
+/**
+ * Funcao para comparar as estatisticas de find_path_stats e de find_path_stats_scratch
+ * com as de uma enumeracao.
+ */
+static bool same_stats(Graph* graph, TraversalScratch* scratch, const Query* q, const PathTally* tally) {
+    PathStats stats, reused;
+    int startId = find_vertex_id(graph, q->row - 1, q->col - 1);
+    int endId = find_vertex_id(graph, q->endRow - 1, q->endCol - 1);
+    return find_path_stats(graph, q->row, q->col, q->endRow, q->endCol, tally->maxHops, &stats) == 0
+        && stats.count == tally->count && stats.shortest == tally->shortest && stats.longest == tally->longest
+        && find_path_stats_scratch(graph, scratch, startId, endId, tally->maxHops, &reused) == 0
+        && reused.count == stats.count && reused.shortest == stats.shortest && reused.longest == stats.longest;
+}
+
+/**
+ * Funcao para comparar find_path_stats com a enumeracao de find_all_paths_visit,
+ * sem limite e com um limite de saltos entre o caminho mais curto e o mais longo.
+ * A versao com buffers partilha os mesmos buffers em todas as consultas.
+ *
+ * \param label - nome do mapa nas mensagens
+ * \param graph - grafo lido do ficheiro
+ * \param queries - consultas
+ * \param count - numero de consultas
+ */
+static void check_path_stats(const char* label, Graph* graph, const Query* queries, int count) {
+    TraversalScratch* scratch = create_scratch(graph);
+    bool same = scratch != NULL;
+    for (int i = 0; i < count && same; i++) {
+        const Query* q = &queries[i];
+        if (q->kind != QUERY_PATHS) continue;
+
+        PathTally all = { 0, -1, -1, -1 };
+        find_all_paths_visit(graph, q->row, q->col, q->endRow, q->endCol, tally_path, &all);
+        same = same_stats(graph, scratch, q, &all);
+        if (!same || all.count == 0) continue;
+
+        PathTally bounded = { 0, -1, -1, (all.shortest + all.longest) / 2 };
+        find_all_paths_visit(graph, q->row, q->col, q->endRow, q->endCol, tally_path, &bounded);
+        same = same_stats(graph, scratch, q, &bounded);
+    }
+    check(same, label, "find_path_stats vs find_all_paths_visit");
+    free_scratch(scratch);
+}
+
+/**
+ * Funcao para obter os vertices e as arestas de um grafo por coordenadas, ordenados.
+ * Cada vertice e registado como (linha, coluna, -1, tipo) e cada aresta como
+ * (linha, coluna, linha do destino, coluna do destino), para comparar grafos com IDs diferentes.
+ *
+ * \param graph - ponteiro para o grafo
+ * \param out - vetor de quadruplos
+ */
+static void graph_by_coordinates(Graph* graph, IntArray* out) {
+    for (int id = 0; id < graph->numVertices; id++) {
+        Vertex* v = get_vertex(graph, id);
+        if (!v) continue;
+        push(out, v->row); push(out, v->col); push(out, -1); push(out, v->type);
+        for (Edge* e = get_neighbours(graph, id); e != NULL; e = e->next) {
+            Vertex* w = get_vertex(graph, e->destId);
+            push(out, v->row); push(out, v->col); push(out, w ? w->row : -1); push(out, w ? w->col : -1);
+        }
+    }
+    qsort(out->items, out->count / 4, sizeof(int) * 4, compare_int4);
+}
+
+/**
+ * Funcao para obter os vertices e as arestas de uma versao por coordenadas, como graph_by_coordinates.
+ *
+ * \param version - versao do grafo
+ * \param out - vetor de quadruplos
+ */
+static void version_by_coordinates(const GraphVersion* version, IntArray* out) {
+    for (int id = 0; id < version->numIds; id++) {
+        const Vertex* v = version_get_vertex(version, id);
+        if (!v) continue;
+        push(out, v->row); push(out, v->col); push(out, -1); push(out, v->type);
+        const int* neighbours;
+        int n = version_neighbours(version, id, &neighbours);
+        for (int i = 0; i < n; i++) {
+            const Vertex* w = version_get_vertex(version, neighbours[i]);
+            push(out, v->row); push(out, v->col); push(out, w ? w->row : -1); push(out, w ? w->col : -1);
+        }
+    }
+    qsort(out->items, out->count / 4, sizeof(int) * 4, compare_int4);
+}
+
+/**
+ * Funcao para registar os vertices de um grafo como (ID, linha, coluna, tipo).
+ *
+ * \param graph - ponteiro para o grafo
+ * \param out - vetor de quadruplos
+ */
+static void graph_vertices(const Graph* graph, IntArray* out) {
+    for (const Vertex* v = graph->vertices; v != NULL; v = v->next) {
+        push(out, v->id); push(out, v->row); push(out, v->col); push(out, v->type);
+    }
+}
+
+/**
+ * Funcao para verificar que as antenas que nao mudaram mantem o ID e que a lista de
+ * vertices continua por ordem de linha e coluna, terminando em graph->tail.
+ *
+ * \param before - vertices antes das alteracoes (graph_vertices)
+ * \param graph - grafo depois das alteracoes
+ * \return true se o grafo respeita as duas condicoes
+ */
+static bool kept_ids_in_order(const IntArray* before, Graph* graph) {
+    for (int i = 0; i < before->count; i += 4) {
+        Vertex* v = get_vertex(graph, find_vertex_id(graph, before->items[i + 1], before->items[i + 2]));
+        if (v && v->type == before->items[i + 3] && v->id != before->items[i]) return false;
+    }
+    const Vertex* last = NULL;
+    for (const Vertex* v = graph->vertices; v != NULL; last = v, v = v->next) {
+        if (last && (last->row > v->row || (last->row == v->row && last->col >= v->col))) return false;
+    }
+    return last == graph->tail;
+}
+
+/**
+ * Funcao para gerar um numero pseudo-aleatorio (igual em todas as plataformas).
+ *
+ * \param state - estado do gerador
+ * \return valor entre 0 e 32767
+ */
+static int next_random(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (int)((*state >> 16) & 0x7FFF);
+}
+
+/**
+ * Funcao para escrever uma revisao de um mapa com MAP_MUTATIONS celulas alteradas
+ * e, para algumas sementes, uma linha nova no fim.
+ *
+ * \param source - ficheiro original
+ * \param target - ficheiro da revisao
+ * \param seed - semente das alteracoes
+ * \return false se algum ficheiro nao abrir
+ */
+static bool write_revision(const char* source, const char* target, unsigned int seed) {
+    FILE* in = fopen(source, "rb");
+    if (!in) return false;
+    char* text = read_text(in);
+    if (!text) return false;
+
+    long length = (long)strlen(text);
+    char types[8] = "A";
+    int numTypes = 1;
+    for (long i = 0; i < length && numTypes < 8; i++)
+        if (text[i] != '.' && text[i] != '\n' && !memchr(types, text[i], numTypes)) types[numTypes++] = text[i];
+
+    unsigned int state = seed;
+    for (int m = 0; m < MAP_MUTATIONS && length > 0; m++) {
+        long i = ((long)next_random(&state) << 15 | next_random(&state)) % length;
+        if (text[i] == '\n') continue;
+        text[i] = next_random(&state) % 2 ? '.' : types[next_random(&state) % numTypes];
+    }
+
+    FILE* out = fopen(target, "wb");
+    if (!out) {
+        free(text);
+        return false;
+    }
+    fputs(text, out);
+    if (seed % 2) fputs(length > 0 && text[length - 1] != '\n' ? "\n..A.\n" : "..A.\n", out);
+    fclose(out);
+    free(text);
+    return true;
+}
+
+/**
+ * Funcao para comparar apply_map_delta e as versoes editadas com a leitura da nova revisao.
+ *
+ * \param config - configuracao dos testes
+ * \param filename - ficheiro do mapa (revisao antiga)
+ * \param label - nome do mapa nas mensagens
+ * \param seed - semente das alteracoes
+ * \param nefastos - true para manter os nefastos na lista
+ */
+static void check_map_delta(const TestConfig* config, const char* filename, const char* label,
+    unsigned int seed, bool nefastos) {
+    if (!write_revision(filename, config->revisionFile, seed)) {
+        check(false, label, "escrita da revisao");
+        return;
+    }
+
+    int rows, cols;
+    Node* expectedList = NULL;
+    read_matrix_from_file(config->revisionFile, &expectedList, &rows, &cols);
+    if (nefastos) detect_nefasto(&expectedList);
+    Graph* fresh = read_graph_from_file(config->revisionFile, &rows, &cols);
+    IntArray expected = { NULL, 0, 0 };
+    int count = 0;
+    Query* queries = fresh ? build_queries(fresh, &count) : NULL;
+    char* expectedText = queries ? oracle_text(fresh, queries, count) : NULL;
+    if (fresh) graph_by_coordinates(fresh, &expected);
+    free_graph(fresh);
+
+    Node* list = NULL;
+    read_matrix_from_file(filename, &list, &rows, &cols);
+    Node* original = NULL;
+    NefastoTracker* tracker = NULL;
+    if (nefastos) {
+        // O estado criado a partir da lista sem nefastos tem de os acrescentar como detect_nefasto
+        tracker = nefasto_tracker_create(&list);
+        read_matrix_from_file(filename, &original, &rows, &cols);
+        detect_nefasto(&original);
+        check(tracker && same_list_with_nefastos(original, list), label, "nefasto_tracker_create vs detect_nefasto");
+    }
+    Graph* graph = read_graph_from_file(filename, &rows, &cols);
+    Graph* lazy = read_graph_lazy(filename, &rows, &cols);
+    IntArray before = { NULL, 0, 0 };
+    if (graph) graph_vertices(graph, &before);
+
+    MapDiffStats stats = { 0, 0, 0, 0 };
+    bool ok = graph && lazy && (!nefastos || tracker)
+        && apply_map_delta(filename, config->revisionFile, &list, graph, tracker, &stats)
+        && apply_map_delta(filename, config->revisionFile, NULL, lazy, NULL, NULL);
+    check(ok && same_list_with_nefastos(expectedList, list), label, "apply_map_delta (lista) vs read_matrix_from_file");
+    if (nefastos) {
+        // O mesmo estado continua valido na revisao seguinte (de volta ao mapa original)
+        bool back = ok && apply_map_delta(config->revisionFile, filename, &list, NULL, tracker, NULL);
+        check(back && same_list_with_nefastos(original, list), label, "apply_map_delta (lista, 2 revisoes) vs detect_nefasto");
+    }
+    nefasto_tracker_free(tracker);
+    deallocate(&original);
+
+    IntArray actual = { NULL, 0, 0 };
+    if (ok) graph_by_coordinates(graph, &actual);
+    check(ok && same_array(&expected, &actual), label, "apply_map_delta (grafo) vs read_graph_from_file");
+    clear_array(&actual);
+    if (ok) graph_by_coordinates(lazy, &actual);
+    check(ok && same_array(&expected, &actual), label, "apply_map_delta (grafo lazy) vs read_graph_from_file");
+    clear_array(&actual);
+    check(ok && kept_ids_in_order(&before, graph), label, "apply_map_delta (grafo): IDs mantidos e vertices por ordem");
+    clear_array(&before);
+    if (ok && stats.inserts + stats.deletes > 0) {
+        // O grafo ja esta na nova revisao: aplicar outra vez as mesmas alteracoes tem de falhar
+        Graph* again = read_graph_from_file(config->revisionFile, &rows, &cols);
+        check(again && !apply_map_delta(filename, config->revisionFile, NULL, again, NULL, NULL), label,
+            "apply_map_delta sobre a revisao errada devolve false");
+        free_graph(again);
+    }
+
+    // A ordem das travessias depende da ordem dos vertices e das listas de adjacencia, nao dos IDs
+    char* text = ok && expectedText ? oracle_text(graph, queries, count) : NULL;
+    check(same_text(expectedText, text), label, "apply_map_delta (grafo) vs read_graph_from_file: texto das consultas");
+    free(text);
+    text = ok && expectedText ? oracle_text(lazy, queries, count) : NULL;
+    check(same_text(expectedText, text), label, "apply_map_delta (grafo lazy) vs read_graph_from_file: texto das consultas");
+    free(text);
+    free(expectedText);
+    free(queries);
+
+    deallocate(&list);
+    deallocate(&expectedList);
+    free_graph(graph);
+    free_graph(lazy);
+
+    // Os mesmos eventos aplicados a um rascunho de versao a partir do grafo antigo
+    graph = read_graph_from_file(filename, &rows, &cols);
+    VersionedGraph* vgraph = graph ? versioned_graph_create(graph) : NULL;
+    SnapshotEdit edit = { vgraph, vgraph ? version_begin(vgraph) : NULL, true };
+    ok = edit.draft && diff_map_files(filename, config->revisionFile, apply_snapshot_event, &edit, NULL) && edit.ok;
+    if (edit.draft) version_publish(vgraph, edit.draft);
+    if (ok) {
+        int slot = snapshot_register_reader(vgraph);
+        version_by_coordinates(snapshot_pin(vgraph, slot), &actual);
+        snapshot_unpin(vgraph, slot);
+        snapshot_unregister_reader(vgraph, slot);
+    }
+    check(ok && same_array(&expected, &actual), label, "SnapshotHandler (versao editada) vs read_graph_from_file");
+    clear_array(&actual);
+    clear_array(&expected);
+    if (vgraph) versioned_graph_free(vgraph);
+    free_graph(graph);
+}
+
+/**
+ * Funcao para executar todas as verificacoes sobre um mapa.
+ *
+ * \param config - configuracao dos testes
+ * \param filename - ficheiro do mapa
+ * \param label - nome do mapa nas mensagens
+ * \param seed - semente das alteracoes usadas em apply_map_delta
+ */
+static void run_map_checks(const TestConfig* config, const char* filename, const char* label, unsigned int seed) {
+    check_readers(config, filename, label);
+
+    int rows, cols;
+    Graph* graph = read_graph_from_file(filename, &rows, &cols);
+    check(graph != NULL, label, "read_graph_from_file");
+    if (!graph) return;
+    bool nefastos = graph->numVertices <= config->nefastoMaxAntennas;
+    check_tiled(filename, label, graph, nefastos);
+
+    int count;
+    Query* queries = build_queries(graph, &count);
+    check(queries != NULL, label, "criacao das consultas");
+    if (queries) {
+        check_queries(config, filename, label, graph, queries, count);
+        check_snapshot(label, graph, queries, count);
+        check_multi_source(label, graph, queries, count);
+        check_path_stats(label, graph, queries, count);
+        free(queries);
+    }
+    free_graph(graph);
+
+    check_map_delta(config, filename, label, seed, nefastos);
+}
+
+#pragma endregion
+
+#pragma region Argumentos
+
+/**
+ * Funcao para ler os argumentos da linha de comandos.
+ *
+ * \param config - configuracao a preencher
+ * \param argc - numero de argumentos
+ * \param argv - argumentos
+ * \return true se os argumentos sao validos
+ */
+static bool parse_args(TestConfig* config, int argc, char** argv) {
+    config->dataDir = "../ProjetoEDA";
+    config->numMaps = 12;
+    config->seed = 1;
+    config->threads = 4;
+    config->nefastoMaxAntennas = 150;
+    config->mapFile = "reference_map.txt";
+    config->revisionFile = "reference_revision.txt";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+
+        if (strcmp(arg, "--data") == 0) config->dataDir = value;
+        else if (strcmp(arg, "--maps") == 0) config->numMaps = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) config->seed = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--threads") == 0) config->threads = atoi(value);
+        else if (strcmp(arg, "--nefasto-max-antennas") == 0) config->nefastoMaxAntennas = atoi(value);
+        else if (strcmp(arg, "--map") == 0) config->mapFile = value;
+        else if (strcmp(arg, "--revision") == 0) config->revisionFile = value;
+        else return false;
+        i++;
+    }
+    return config->numMaps >= 0 && config->threads > 0;
+}
+
+#pragma endregion
+
+/**
+ * @brief Funcao principal dos testes diferenciais.
+ * @return 0 se todas as verificacoes passaram, 1 caso contrario.
+ */
+int main(int argc, char** argv) {
+    TestConfig config;
+    if (!parse_args(&config, argc, argv)) {
+        fprintf(stderr, "Uso: %s [--data pasta] [--maps N] [--seed S] [--threads N]\n"
+            "          [--nefasto-max-antennas N] [--map ficheiro] [--revision ficheiro]\n", argv[0]);
+        return 1;
+    }
+
+    static const char* bundled[] = { "Mapa.txt", "Mapa2.txt", "Mapa3.txt" };
+    for (int i = 0; i < 3; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", config.dataDir, bundled[i]);
+        FILE* file = fopen(path, "r");
+        check(file != NULL, bundled[i], "ficheiro nao encontrado (usar --data)");
+        if (!file) continue;
+        fclose(file);
+        run_map_checks(&config, path, bundled[i], config.seed + i);
+    }
+
+    // Fins de linha "\r\n" e '\r' soltos: os leitores seguem o modo de texto de read_matrix_from_file
+    static const char* crlfMaps[] = { "A..\r\n.A.\r\n..A\r\n", "A\r.\r\n\r\n.\rA" };
+    for (int i = 0; i < 2; i++) {
+        FILE* file = fopen(config.mapFile, "wb");
+        check(file != NULL, config.mapFile, "escrita do mapa com \\r");
+        if (!file) break;
+        fputs(crlfMaps[i], file);
+        fclose(file);
+        char label[32];
+        snprintf(label, sizeof(label), "mapa com \\r %d", i + 1);
+        check_readers(&config, config.mapFile, label);
+    }
+
+    // Mapas gerados: escalas e densidades alternadas, com 2 a 4 tipos. O mapa de 700x300
+    // (mais de 200 KiB) e dividido em varias faixas por read_matrix_parallel.
+    static const int sizes[][2] = { {8, 8}, {20, 20}, {30, 45}, {40, 40}, {64, 64}, {1, 50}, {700, 300} };
+    static const double densities[] = { 0.25, 0.12, 0.08, 0.05 };
+    const int numSizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    for (int i = 0; i < config.numMaps; i++) {
+        MapGenOptions gen;
+        mapgen_default_options(&gen);
+        gen.rows = sizes[i % numSizes][0];
+        gen.cols = sizes[i % numSizes][1];
+        gen.density = densities[i % 4];
+        // read_matrix_from_file acrescenta no fim da lista (O(n^2)): mapas grandes mais esparsos
+        if ((long long)gen.rows * gen.cols > 100000) gen.density = 0.02;
+        gen.numTypes = 2 + i % 3;
+        gen.clustering = 0.3;
+        gen.seed = config.seed + (unsigned int)i;
+        if (!write_generated_map(config.mapFile, &gen)) {
+            check(false, config.mapFile, "write_generated_map");
+            break;
+        }
+
+        char label[96];
+        snprintf(label, sizeof(label), "gerado %dx%d densidade %.2f semente %u", gen.rows, gen.cols, gen.density, gen.seed);
+        run_map_checks(&config, config.mapFile, label, gen.seed);
+    }
+
+    remove(config.mapFile);
+    remove(config.revisionFile);
+    printf("%d verificacoes, %d falhadas\n", checksRun, checksFailed);
+    return checksFailed == 0 ? 0 : 1;
+}